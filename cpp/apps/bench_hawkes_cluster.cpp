@@ -0,0 +1,137 @@
+#include "hawkes_cluster_generator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Generating one long pure-Hawkes path over a fixed horizon: the sequential
+// thinning loop vs. the cluster generator on 1, 2, 4, ... threads (up to the
+// hardware count). Also checks that the cluster output does not depend on
+// the thread count and that both event rates match the stationary rate
+// sum((I - alpha/beta)^-1 mu).
+//
+// Usage: bench_hawkes_cluster [horizon] [repetitions]
+// (configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers)
+
+namespace {
+
+using Matrix = std::vector<std::vector<double>>;
+
+// The frontend's calm_market preset
+const std::vector<double> kMu = {2.0, 2.0, 1.0, 1.0, 1.5, 1.5};
+const Matrix kAlpha = {
+    {0.6, 0.1, 0.1, 0.0, 0.2, 0.0}, {0.1, 0.6, 0.0, 0.1, 0.0, 0.2},
+    {0.1, 0.0, 0.4, 0.1, 0.1, 0.0}, {0.0, 0.1, 0.1, 0.4, 0.0, 0.1},
+    {0.2, 0.0, 0.1, 0.0, 0.5, 0.1}, {0.0, 0.2, 0.0, 0.1, 0.1, 0.5},
+};
+const Matrix kBeta(6, std::vector<double>(6, 1.5));
+
+// Solves (I - alpha/beta) x = mu by Gaussian elimination
+double stationary_rate()
+{
+    const std::size_t d = kMu.size();
+    Matrix a(d, std::vector<double>(d + 1));
+    for (std::size_t i = 0; i < d; ++i) {
+        for (std::size_t j = 0; j < d; ++j) {
+            a[i][j] = (i == j ? 1.0 : 0.0) - kAlpha[i][j] / kBeta[i][j];
+        }
+        a[i][d] = kMu[i];
+    }
+    for (std::size_t c = 0; c < d; ++c) {
+        for (std::size_t r = c + 1; r < d; ++r) {
+            const double f = a[r][c] / a[c][c];
+            for (std::size_t k = c; k <= d; ++k) a[r][k] -= f * a[c][k];
+        }
+    }
+    double total = 0.0;
+    std::vector<double> x(d);
+    for (std::size_t i = d; i-- > 0;) {
+        double v = a[i][d];
+        for (std::size_t k = i + 1; k < d; ++k) v -= a[i][k] * x[k];
+        x[i] = v / a[i][i];
+        total += x[i];
+    }
+    return total;
+}
+
+template <typename Fill>
+double best_seconds(Fill fill, EventBuffer& out, int reps)
+{
+    using clock = std::chrono::steady_clock;
+    double best = 1e300;
+    for (int r = 0; r < reps; ++r) {
+        out.clear();
+        const auto start = clock::now();
+        fill(out);
+        const auto stop = clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+bool same_stream(const EventBuffer& a, const EventBuffer& b)
+{
+    return a.size() == b.size() && std::equal(a.stamps(), a.stamps() + a.size(), b.stamps()) &&
+           std::equal(a.quantities(), a.quantities() + a.size(), b.quantities());
+}
+
+void report(const char* name, double secs, const EventBuffer& out, double horizon)
+{
+    std::cout << std::left << std::setw(14) << name << std::right << std::fixed
+              << std::setw(12) << out.size() << std::setprecision(3) << std::setw(10) << secs
+              << std::setprecision(2) << std::setw(10)
+              << static_cast<double>(out.size()) / secs / 1e6 << std::setprecision(3)
+              << std::setw(10) << static_cast<double>(out.size()) / horizon;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    const double horizon = argc > 1 ? std::atof(argv[1]) : 200000.0;
+    const int reps = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    std::cout << "horizon: " << horizon << "  stationary rate: " << stationary_rate()
+              << "  hardware threads: " << std::thread::hardware_concurrency() << "\n"
+              << "                  events   seconds  Mevents/s  rate\n";
+
+    EventBuffer thinned;
+    const double thin_secs = best_seconds([&](EventBuffer& out) {
+        HawkesMultivariateProcess process(kMu, kAlpha, kBeta, 5, 50, 42);
+        double t = 0.0;
+        while (true) {
+            const Event e = process.next(t);
+            if (e.t >= horizon) break;
+            t = e.t;
+            out.push(e);
+        }
+    }, thinned, reps);
+    report("thinning", thin_secs, thinned, horizon);
+    std::cout << "\n";
+
+    const HawkesClusterGenerator generator(kMu, kAlpha, kBeta, 5, 50, 42);
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    EventBuffer reference;
+    for (unsigned threads = 1; threads <= hw; threads *= 2) {
+        EventBuffer clustered;
+        const double secs = best_seconds([&](EventBuffer& out) {
+            generator.generate(horizon, out, threads);
+        }, clustered, reps);
+
+        const std::string name = "cluster x" + std::to_string(threads);
+        report(name.c_str(), secs, clustered, horizon);
+        std::cout << std::setprecision(2) << "  " << thin_secs / secs << "x";
+        if (threads == 1) {
+            reference = clustered;
+        } else {
+            std::cout << (same_stream(reference, clustered) ? "  same stream" : "  STREAM DIFFERS");
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "hawkes_exact_process.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Ogata thinning vs. exact (Dassios-Zhao) sampling on the frontend's regime
+// presets (frontend/src/utils/regimePresets.js) and on a univariate process:
+// events per second (best of several repetitions), acceptance rate
+// (events / candidate times) and the simulated event rate, which should
+// agree between the two engines.
+//
+// Usage: bench_hawkes_samplers [num_events] [repetitions]
+// (configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers)
+
+namespace {
+
+using Matrix = std::vector<std::vector<double>>;
+
+struct Preset {
+    const char* name;
+    std::vector<double> mu;
+    Matrix alpha;
+    double beta;   // the presets use one decay rate for every pair
+};
+
+std::vector<Preset> presets()
+{
+    return {
+        {"calm_market", {2.0, 2.0, 1.0, 1.0, 1.5, 1.5},
+         {{0.6, 0.1, 0.1, 0.0, 0.2, 0.0}, {0.1, 0.6, 0.0, 0.1, 0.0, 0.2},
+          {0.1, 0.0, 0.4, 0.1, 0.1, 0.0}, {0.0, 0.1, 0.1, 0.4, 0.0, 0.1},
+          {0.2, 0.0, 0.1, 0.0, 0.5, 0.1}, {0.0, 0.2, 0.0, 0.1, 0.1, 0.5}},
+         1.5},
+        {"volatile_market", {4.0, 4.0, 2.5, 2.5, 3.0, 3.0},
+         {{0.8, 0.2, 0.2, 0.0, 0.3, 0.0}, {0.2, 0.8, 0.0, 0.2, 0.0, 0.3},
+          {0.2, 0.0, 0.7, 0.2, 0.2, 0.0}, {0.0, 0.2, 0.2, 0.7, 0.0, 0.2},
+          {0.3, 0.0, 0.2, 0.0, 0.8, 0.2}, {0.0, 0.3, 0.0, 0.2, 0.2, 0.8}},
+         2.5},
+        {"trending_up", {3.0, 1.5, 1.2, 0.8, 2.0, 1.0},
+         {{0.7, 0.1, 0.15, 0.0, 0.25, 0.0}, {0.1, 0.5, 0.0, 0.1, 0.0, 0.15},
+          {0.15, 0.0, 0.5, 0.1, 0.15, 0.0}, {0.0, 0.1, 0.1, 0.4, 0.0, 0.1},
+          {0.25, 0.0, 0.15, 0.0, 0.6, 0.1}, {0.0, 0.15, 0.0, 0.1, 0.1, 0.5}},
+         1.8},
+        {"trending_down", {1.5, 3.0, 0.8, 1.2, 1.0, 2.0},
+         {{0.5, 0.1, 0.15, 0.0, 0.15, 0.0}, {0.1, 0.7, 0.0, 0.15, 0.0, 0.25},
+          {0.15, 0.0, 0.4, 0.1, 0.1, 0.0}, {0.0, 0.15, 0.1, 0.5, 0.0, 0.15},
+          {0.15, 0.0, 0.1, 0.0, 0.5, 0.1}, {0.0, 0.25, 0.0, 0.15, 0.1, 0.6}},
+         1.8},
+        {"mean_reverting", {2.0, 2.0, 2.5, 2.5, 1.0, 1.0},
+         {{0.5, 0.1, 0.3, 0.0, 0.1, 0.0}, {0.1, 0.5, 0.0, 0.3, 0.0, 0.1},
+          {0.3, 0.0, 0.7, 0.2, 0.2, 0.0}, {0.0, 0.3, 0.2, 0.7, 0.0, 0.2},
+          {0.1, 0.0, 0.2, 0.0, 0.4, 0.1}, {0.0, 0.1, 0.0, 0.2, 0.1, 0.4}},
+         2.0},
+        {"flash_crash", {0.5, 5.0, 0.3, 3.0, 0.5, 4.0},
+         {{0.3, 0.1, 0.1, 0.0, 0.1, 0.0}, {0.1, 0.9, 0.0, 0.3, 0.0, 0.4},
+          {0.1, 0.0, 0.2, 0.1, 0.1, 0.0}, {0.0, 0.3, 0.1, 0.8, 0.0, 0.3},
+          {0.1, 0.0, 0.1, 0.0, 0.3, 0.1}, {0.0, 0.4, 0.0, 0.3, 0.1, 0.9}},
+         3.0},
+    };
+}
+
+struct Result {
+    double events_per_sec = 0.0;
+    double acceptance = 0.0;
+    double event_rate = 0.0;   // events per unit of simulated time
+};
+
+template <typename MakeProcess>
+Result run(MakeProcess make, std::size_t n, int reps)
+{
+    using clock = std::chrono::steady_clock;
+    Result best;
+
+    for (int r = 0; r < reps; ++r) {
+        auto process = make();
+        double t = 0.0;
+        const auto start = clock::now();
+        for (std::size_t i = 0; i < n; ++i) t = process.next(t).t;
+        const auto stop = clock::now();
+
+        const double secs = std::chrono::duration<double>(stop - start).count();
+        best.events_per_sec = std::max(best.events_per_sec, static_cast<double>(n) / secs);
+        best.acceptance = static_cast<double>(n) / static_cast<double>(process.proposals());
+        best.event_rate = static_cast<double>(n) / t;
+    }
+    return best;
+}
+
+void report(const char* name, const Result& thinning, const Result& exact)
+{
+    std::cout << std::left << std::setw(18) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(9) << thinning.events_per_sec / 1e6
+              << std::setw(9) << exact.events_per_sec / 1e6 << std::setw(8)
+              << exact.events_per_sec / thinning.events_per_sec << "x" << std::setprecision(3)
+              << std::setw(9) << thinning.acceptance << std::setw(9) << exact.acceptance
+              << std::setprecision(2) << std::setw(10) << thinning.event_rate
+              << std::setw(10) << exact.event_rate << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const int reps = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::cout << "events: " << n << "\n"
+              << "                  Mevents/s (thin, exact)   acceptance        events/time\n";
+
+    for (const Preset& p : presets()) {
+        const Matrix beta(p.mu.size(), std::vector<double>(p.mu.size(), p.beta));
+        const Result thinning = run([&] {
+            return HawkesMultivariateProcess(p.mu, p.alpha, beta, 5, 50, 42);
+        }, n, reps);
+        const Result exact = run([&] {
+            return HawkesMultivariateExactProcess(p.mu, p.alpha, beta, 5, 50, 42);
+        }, n, reps);
+        report(p.name, thinning, exact);
+    }
+
+    // Strongly self-exciting univariate process (branching ratio 0.8)
+    const Result thinning = run([] {
+        return HawkesUnivariateProcess(1.0, 2.0, 2.5, 100.0, 0.1, 5, 50, 42);
+    }, n, reps);
+    const Result exact = run([] {
+        return HawkesUnivariateExactProcess(1.0, 2.0, 2.5, 100.0, 0.1, 5, 50, 42);
+    }, n, reps);
+    report("univariate", thinning, exact);
+
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include "order_book.h"
+#include "order_book_l3.h"
+#include "hawkes_multivariate_process.h"
+#include "random_buffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Replays one Hawkes-driven event stream through the runtime-configured
+// OrderBook and a fixed-window BasicOrderBook and reports the
+// cost per event of each (best of several repetitions), both for apply()
+// alone and for apply_batch() writing the per-event top-of-book columns.
+// The same stream also goes through the order-level OrderBookL3, where every
+// resting Add becomes an order with its own ID, FIFO queue position and
+// per-order fills; its top of book is checked against OrderBook's.
+//
+// Usage: bench_order_book [num_events] [repetitions] [journal]
+// With a journal file (see BookJournal::save) its events are replayed instead
+// of a freshly generated workload.
+// (configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers)
+
+namespace {
+
+// Specialized variant: a fixed 1024-tick window known to the compiler
+using FastBook = BasicOrderBook<1024>;
+
+constexpr double kTick = 0.1;
+
+// Same parameters and placement rules as simulate_hawkes_multivariate, with
+// the safety-net refills recorded as events so the stream replays exactly
+std::vector<Event> hawkes_workload(std::size_t n)
+{
+    const Tick center = to_ticks(100.0, kTick);
+
+    std::vector<double> mu = {1.5, 1.5, 0.8, 0.8, 1.0, 1.0};
+    std::vector<std::vector<double>> alpha = {
+        {0.6, 0.1, 0.1, 0.0, 0.2, 0.0},
+        {0.1, 0.6, 0.0, 0.1, 0.0, 0.2},
+        {0.1, 0.0, 0.4, 0.1, 0.1, 0.0},
+        {0.0, 0.1, 0.1, 0.4, 0.0, 0.1},
+        {0.2, 0.0, 0.1, 0.0, 0.5, 0.1},
+        {0.0, 0.2, 0.0, 0.1, 0.1, 0.5}
+    };
+    std::vector<std::vector<double>> beta(6, std::vector<double>(6, 1.5));
+
+    HawkesMultivariateProcess process(mu, alpha, beta, 5, 50, 42);
+    OrderBook book(kTick);
+    BufferedRandom place_rng = BufferedRandom::stream(42, 1);
+
+    std::vector<Event> events;
+    events.reserve(n + n / 8);
+    auto push = [&](const Event& e) {
+        book.apply(e);
+        events.push_back(e);
+    };
+
+    for (int k = 1; k <= 10; ++k) {
+        push({0.0, center - k, 60, EventType::Add, Side::Bid});
+        push({0.0, center + k, 60, EventType::Add, Side::Ask});
+    }
+
+    double t = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        Event e = process.next(t);
+        t = e.t;
+
+        if (book.bid_levels() == 0) push({t, center - 1, 50, EventType::Add, Side::Bid});
+        if (book.ask_levels() == 0) push({t, center + 1, 50, EventType::Add, Side::Ask});
+
+        const TopOfBook tob = book.top();
+        const Tick bid = *tob.best_bid_price;
+        const Tick ask = *tob.best_ask_price;
+
+        if (e.type == EventType::Add) {
+            const int improve = (ask - bid >= 3) ? 45 : 20;
+            const int roll = rng::uniform_int(place_rng, 0, 99);
+            const bool bid_side = (e.side == Side::Bid);
+            if (roll < improve && bid + 1 < ask) {
+                e.price = bid_side ? bid + 1 : ask - 1;
+            } else if (roll < improve + 50) {
+                e.price = bid_side ? bid : ask;
+            } else {
+                const int depth = rng::uniform_int(place_rng, 1, 5);
+                e.price = bid_side ? bid - depth : ask + depth;
+            }
+        } else if (e.type == EventType::Cancel) {
+            e.price = (e.side == Side::Bid) ? bid : ask;
+        } else {
+            e.price = 0;
+        }
+        push(e);
+    }
+    return events;
+}
+
+struct Columns {
+    explicit Columns(std::size_t n)
+        : bid(n), ask(n), bid_qty(n), ask_qty(n), mid(n), spread(n), imbalance(n)
+    {
+    }
+
+    BookSeries series()
+    {
+        BookSeries s;
+        s.best_bid = bid.data();
+        s.best_ask = ask.data();
+        s.best_bid_qty = bid_qty.data();
+        s.best_ask_qty = ask_qty.data();
+        s.mid = mid.data();
+        s.spread = spread.data();
+        s.imbalance_top1 = imbalance.data();
+        return s;
+    }
+
+    std::vector<Tick> bid, ask;
+    std::vector<int> bid_qty, ask_qty;
+    std::vector<double> mid, spread, imbalance;
+};
+
+struct Timing {
+    double apply_ns = 1e300;   // apply() only
+    double batch_ns = 1e300;   // apply_batch() with all series columns
+};
+
+template <typename Book>
+Timing best_ns_per_event(const std::vector<Event>& events, int reps, Columns& out)
+{
+    using clock = std::chrono::steady_clock;
+    const BookSeries series = out.series();
+    const double n = static_cast<double>(events.size());
+    auto per_event = [n](clock::time_point start, clock::time_point stop) {
+        return std::chrono::duration<double, std::nano>(stop - start).count() / n;
+    };
+    Timing best;
+
+    for (int r = 0; r < reps; ++r) {
+        Book book(kTick);
+        auto start = clock::now();
+        for (const Event& e : events) book.apply(e);
+        auto stop = clock::now();
+        best.apply_ns = std::min(best.apply_ns, per_event(start, stop));
+
+        Book batch_book(kTick);
+        start = clock::now();
+        batch_book.apply_batch(events.data(), events.size(), series);
+        stop = clock::now();
+        best.batch_ns = std::min(best.batch_ns, per_event(start, stop));
+    }
+    return best;
+}
+
+// apply() cost of the order-level book on the same stream
+double l3_ns_per_event(const std::vector<Event>& events, int reps)
+{
+    using clock = std::chrono::steady_clock;
+    double best = 1e300;
+    for (int r = 0; r < reps; ++r) {
+        OrderBookL3 book(kTick, events.size() / 4);
+        const auto start = clock::now();
+        for (const Event& e : events) book.apply(e);
+        const auto stop = clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count() /
+                                  static_cast<double>(events.size()));
+    }
+    return best;
+}
+
+// Events after which the L3 book's top of book differs from OrderBook's
+std::size_t l3_mismatches(const std::vector<Event>& events)
+{
+    OrderBook l2(kTick);
+    OrderBookL3 l3(kTick);
+    std::size_t mismatches = 0;
+    for (const Event& e : events) {
+        l2.apply(e);
+        l3.apply(e);
+        const TopOfBook a = l2.top();
+        const TopOfBook b = l3.top();
+        if (a.best_bid_price != b.best_bid_price || a.best_bid_qty != b.best_bid_qty ||
+            a.best_ask_price != b.best_ask_price || a.best_ask_qty != b.best_ask_qty) {
+            ++mismatches;
+        }
+    }
+    return mismatches;
+}
+
+bool same(double a, double b)
+{
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    const int reps = argc > 2 ? std::atoi(argv[2]) : 7;
+
+    std::vector<Event> events;
+    if (argc > 3) {
+        BookJournal journal;
+        if (!journal.load(argv[3])) {
+            std::cerr << "ERROR: could not read journal " << argv[3] << "\n";
+            return 1;
+        }
+        events.reserve(journal.size());
+        for (std::size_t i = 0; i < journal.size(); ++i) events.push_back(journal.events()[i]);
+    } else {
+        events = hawkes_workload(n);
+    }
+
+    Columns runtime_cols(events.size());
+    Columns fast_cols(events.size());
+    const Timing runtime = best_ns_per_event<OrderBook>(events, reps, runtime_cols);
+    const Timing fast = best_ns_per_event<FastBook>(events, reps, fast_cols);
+    const double l3 = l3_ns_per_event(events, reps);
+
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        if (runtime_cols.bid[i] != fast_cols.bid[i] || runtime_cols.ask[i] != fast_cols.ask[i] ||
+            runtime_cols.bid_qty[i] != fast_cols.bid_qty[i] ||
+            runtime_cols.ask_qty[i] != fast_cols.ask_qty[i] ||
+            !same(runtime_cols.mid[i], fast_cols.mid[i]) ||
+            !same(runtime_cols.spread[i], fast_cols.spread[i]) ||
+            !same(runtime_cols.imbalance[i], fast_cols.imbalance[i])) {
+            ++mismatches;
+        }
+    }
+
+    std::cout << "events:      " << events.size() << "\n"
+              << "                 apply   apply_batch  (ns/event)\n"
+              << "OrderBook:   " << runtime.apply_ns << "  " << runtime.batch_ns << "\n"
+              << "FastBook:    " << fast.apply_ns << "  " << fast.batch_ns << "\n"
+              << "OrderBookL3: " << l3 << "\n"
+              << "speedup:     " << runtime.apply_ns / fast.apply_ns << "x  "
+              << runtime.batch_ns / fast.batch_ns << "x\n"
+              << "L3 / L2:     " << l3 / runtime.apply_ns << "x\n"
+              << "mismatches:  " << mismatches << "\n";
+
+    const std::size_t l3_diff = l3_mismatches(events);
+    std::cout << "L3 mismatches: " << l3_diff << "\n";
+
+    return mismatches == 0 && l3_diff == 0 ? 0 : 1;
+}
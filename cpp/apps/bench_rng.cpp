@@ -0,0 +1,111 @@
+#include "hawkes_multivariate_process.h"
+#include "random_buffer.h"
+#include "rng.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// RNG policies: nanoseconds per uniform, exponential and integer-range draw
+// for std::mt19937 with the <random> distributions (what the processes used
+// before), for the rng.h samplers on std::mt19937_64, Xoshiro256pp and
+// Philox4x32, and for the pre-drawn BufferedRandom blocks, then the
+// multivariate Hawkes thinning loop with each 64-bit policy. Best of several
+// repetitions.
+//
+// Usage: bench_rng [num_draws] [repetitions]
+// (configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers)
+
+namespace {
+
+template <typename Body>
+double best_ns(Body body, std::size_t n, int reps)
+{
+    using clock = std::chrono::steady_clock;
+    double best = 1e300;
+    double sink = 0.0;
+    for (int r = 0; r < reps; ++r) {
+        const auto start = clock::now();
+        sink += body(n);
+        const auto stop = clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count() /
+                                  static_cast<double>(n));
+    }
+    if (sink == 42.0) std::cout << "";   // keep the loops observable
+    return best;
+}
+
+void row(const char* name, double uniform, double exponential, double integer)
+{
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << uniform << std::setw(10)
+              << exponential << std::setw(10) << integer << "\n";
+}
+
+void std_row(std::size_t n, int reps)
+{
+    std::mt19937 g(42);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    std::exponential_distribution<double> expo(2.0);
+    std::uniform_int_distribution<int> ints(5, 50);
+    row("mt19937 + <random>",
+        best_ns([&](std::size_t m) { double s = 0; for (std::size_t i = 0; i < m; ++i) s += uni(g); return s; }, n, reps),
+        best_ns([&](std::size_t m) { double s = 0; for (std::size_t i = 0; i < m; ++i) s += expo(g); return s; }, n, reps),
+        best_ns([&](std::size_t m) { double s = 0; for (std::size_t i = 0; i < m; ++i) s += ints(g); return s; }, n, reps));
+}
+
+template <typename Rng>
+void sampler_row(const char* name, std::size_t n, int reps)
+{
+    Rng g(42);
+    row(name,
+        best_ns([&](std::size_t m) { double s = 0; for (std::size_t i = 0; i < m; ++i) s += rng::uniform01(g); return s; }, n, reps),
+        best_ns([&](std::size_t m) { double s = 0; for (std::size_t i = 0; i < m; ++i) s += rng::exponential(g, 2.0); return s; }, n, reps),
+        best_ns([&](std::size_t m) { double s = 0; for (std::size_t i = 0; i < m; ++i) s += rng::uniform_int(g, 5, 50); return s; }, n, reps));
+}
+
+template <typename Rng>
+void process_row(const char* name, std::size_t n, int reps)
+{
+    const std::vector<double> mu = {2.0, 2.0, 1.0, 1.0, 1.5, 1.5};
+    std::vector<std::vector<double>> alpha(6, std::vector<double>(6, 0.05));
+    for (std::size_t i = 0; i < 6; ++i) alpha[i][i] = 0.5;
+    const std::vector<std::vector<double>> beta(6, std::vector<double>(6, 1.5));
+
+    const double ns = best_ns([&](std::size_t m) {
+        BasicHawkesMultivariateProcess<0, Rng> process(mu, alpha, beta, 5, 50, 42);
+        double t = 0.0;
+        for (std::size_t i = 0; i < m; ++i) t = process.next(t).t;
+        return t;
+    }, n, reps);
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << ns << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+    const int reps = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::cout << "draws: " << n << "\n"
+              << "ns/draw                  uniform       exp  int range\n";
+    std_row(n, reps);
+    sampler_row<std::mt19937_64>("mt19937_64 + rng::", n, reps);
+    sampler_row<Xoshiro256pp>("Xoshiro256pp + rng::", n, reps);
+    sampler_row<Philox4x32>("Philox4x32 + rng::", n, reps);
+    sampler_row<BufferedRandom>("BufferedRandom", n, reps);
+
+    std::cout << "\nHawkes 6-D thinning   ns/event\n";
+    process_row<std::mt19937_64>("mt19937_64", n / 10, reps);
+    process_row<Xoshiro256pp>("Xoshiro256pp", n / 10, reps);
+    process_row<Philox4x32>("Philox4x32", n / 10, reps);
+    process_row<BufferedRandom>("BufferedRandom", n / 10, reps);
+    return 0;
+}
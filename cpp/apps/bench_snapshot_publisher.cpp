@@ -0,0 +1,120 @@
+#include "book_manager.h"
+#include "order_book.h"
+#include "rng.h"
+#include "snapshot_publisher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// One writer thread replays an event stream through a BookManager book and
+// publishes its top 5 levels after every event; one reader thread polls the
+// SnapshotPublisher the whole time. Every view the reader obtains is checked
+// against the snapshot an OrderBook had after the same number of events, so
+// a torn read shows up as a mismatch. Reports the publish cost per event and
+// how often the reader had to retry.
+//
+// Usage: bench_snapshot_publisher [num_events]
+// (configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers)
+
+namespace {
+
+constexpr std::size_t kLevels = 5;
+using Snapshot = DepthSnapshot<kLevels>;
+
+// Adds, cancels and market orders within 20 ticks of a fixed centre
+std::vector<Event> workload(std::size_t n)
+{
+    Xoshiro256pp g(42);
+    std::vector<Event> events(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        Event& e = events[i];
+        e.t = static_cast<double>(i + 1);
+        const int roll = rng::uniform_int(g, 0, 99);
+        e.type = roll < 60 ? EventType::Add : (roll < 90 ? EventType::Cancel : EventType::Market);
+        e.side = rng::bernoulli(g, 0.5) ? Side::Bid : Side::Ask;
+        e.price = e.side == Side::Bid ? 1000 - rng::uniform_int(g, 0, 20)
+                                      : 1001 + rng::uniform_int(g, 0, 20);
+        e.quantity = rng::uniform_int(g, 5, 50);
+    }
+    return events;
+}
+
+bool same(const Snapshot& a, const Snapshot& b)
+{
+    if (a.bid_count != b.bid_count || a.ask_count != b.ask_count) return false;
+    for (std::size_t i = 0; i < a.bid_count; ++i) {
+        if (a.bid_price[i] != b.bid_price[i] || a.bid_qty[i] != b.bid_qty[i]) return false;
+    }
+    for (std::size_t i = 0; i < a.ask_count; ++i) {
+        if (a.ask_price[i] != b.ask_price[i] || a.ask_qty[i] != b.ask_qty[i]) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const std::vector<Event> events = workload(n);
+
+    // Reference: the snapshot after each event, taken single-threaded
+    std::vector<Snapshot> expected(n);
+    {
+        OrderBook book(0.1);
+        for (std::size_t i = 0; i < n; ++i) {
+            book.apply(events[i]);
+            book.snapshot(expected[i]);
+        }
+    }
+
+    BookManager books(1);
+    books.add_instrument(0.1);
+    SnapshotPublisher<kLevels> publisher;
+    std::atomic<bool> done{false};
+
+    std::size_t reads = 0;
+    std::size_t retries = 0;
+    std::size_t mismatches = 0;
+    std::thread reader([&] {
+        BookView<kLevels> view;
+        while (!done.load(std::memory_order_acquire)) {
+            if (!publisher.try_read(view)) {
+                ++retries;
+                continue;
+            }
+            if (view.version == 0) continue;
+            ++reads;
+            const std::size_t i = static_cast<std::size_t>(view.version - 1);
+            if (i >= n || view.t != events[i].t || !same(view.depth, expected[i])) ++mismatches;
+        }
+    });
+
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    for (const Event& e : events) {
+        books.apply(e);
+        publisher.publish(books.book(0), e.t);
+    }
+    const auto stop = clock::now();
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    BookView<kLevels> last;
+    publisher.read(last);
+    if (last.version != n || !same(last.depth, expected[n - 1])) ++mismatches;
+
+    const double ns = std::chrono::duration<double, std::nano>(stop - start).count() /
+                      static_cast<double>(n);
+    std::cout << "events:          " << n << "\n"
+              << "apply + publish: " << ns << " ns/event\n"
+              << "reads:           " << reads << "  (retries " << retries << ")\n"
+              << "mismatches:      " << mismatches << "\n";
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -1,10 +1,10 @@
 #include "order_book.h"
 #include "hawkes_multivariate_process.h"
+#include "random_buffer.h"
 #include "csv_logger.h"
 
 #include <iostream>
 #include <vector>
-#include <random>
 #include <algorithm>
 #include <cmath>
 
@@ -21,11 +21,9 @@ static std::vector<double> compute_weights(const OrderBook& book)
         return w; // neutral if book incomplete
     }
 
-    const double bid = *tob.best_bid_price;
-    const double ask = *tob.best_ask_price;
-    const double tick = book.tick_size();
-    const double spread = ask - bid;
-    const double spread_ticks = (tick > 0.0) ? (spread / tick) : 1.0;
+    const Tick bid = *tob.best_bid_price;
+    const Tick ask = *tob.best_ask_price;
+    const double spread_ticks = static_cast<double>(ask - bid);
 
     const double qb = tob.best_bid_qty ? static_cast<double>(*tob.best_bid_qty) : 0.0;
     const double qa = tob.best_ask_qty ? static_cast<double>(*tob.best_ask_qty) : 0.0;
@@ -56,13 +54,13 @@ static std::vector<double> compute_weights(const OrderBook& book)
 // ------------------------------------------------------------
 int main()
 {
-    const double price_center = 100.0;
     const double tick = 0.1;
+    const Tick price_center = to_ticks(100.0, tick);
 
     OrderBook book(tick);
 
     // CSV logger (write into build folder or current working directory)
-    CsvLogger logger("lob_events.csv");
+    CsvLogger logger("lob_events.csv", tick);
     if (!logger.is_open()) {
         std::cerr << "ERROR: could not open lob_events.csv for writing\n";
         return 1;
@@ -91,14 +89,12 @@ int main()
     );
 
     // RNG for placement logic (reproducible)
-    std::mt19937 rng(42);
-    std::uniform_int_distribution<int> place_dist(0, 99);
-    std::uniform_int_distribution<int> depth_dist(1, 5);  // 1–5 ticks behind
+    BufferedRandom place_rng = BufferedRandom::stream(42, 1);
 
     // ---------------- Seed deep book ----------------
     for (int k = 1; k <= 10; ++k) {
-        book.apply({0.0, EventType::Add, Side::Bid, price_center - k * tick, 60});
-        book.apply({0.0, EventType::Add, Side::Ask, price_center + k * tick, 60});
+        book.apply({0.0, price_center - k, 60, EventType::Add, Side::Bid});
+        book.apply({0.0, price_center + k, 60, EventType::Add, Side::Ask});
     }
 
     double t = 0.0;
@@ -113,47 +109,47 @@ int main()
         // Safety net: never let the book go empty
         TopOfBook tob = book.top();
         if (!tob.best_bid_price) {
-            book.apply({t, EventType::Add, Side::Bid, price_center - tick, 50});
+            book.apply({t, price_center - 1, 50, EventType::Add, Side::Bid});
         }
         if (!tob.best_ask_price) {
-            book.apply({t, EventType::Add, Side::Ask, price_center + tick, 50});
+            book.apply({t, price_center + 1, 50, EventType::Add, Side::Ask});
         }
 
         tob = book.top();
-        const double best_bid = *tob.best_bid_price;
-        const double best_ask = *tob.best_ask_price;
-        const double spread_ticks = (best_ask - best_bid) / tick;
+        const Tick best_bid = *tob.best_bid_price;
+        const Tick best_ask = *tob.best_ask_price;
+        const Tick spread_ticks = best_ask - best_bid;
 
         // ---------------- Placement logic ----------------
         if (e.type == EventType::Add) {
-            double improve_prob = (spread_ticks >= 3.0) ? 0.45 : 0.20;
+            double improve_prob = (spread_ticks >= 3) ? 0.45 : 0.20;
             double join_prob    = 0.50;
 
-            int roll = place_dist(rng);
+            int roll = rng::uniform_int(place_rng, 0, 99);
 
             if (e.side == Side::Bid) {
-                if (roll < static_cast<int>(improve_prob * 100) && (best_bid + tick < best_ask)) {
-                    e.price = best_bid + tick;
+                if (roll < static_cast<int>(improve_prob * 100) && (best_bid + 1 < best_ask)) {
+                    e.price = best_bid + 1;
                 } else if (roll < static_cast<int>((improve_prob + join_prob) * 100)) {
                     e.price = best_bid;
                 } else {
-                    int depth = depth_dist(rng);
-                    e.price = best_bid - depth * tick;
+                    int depth = rng::uniform_int(place_rng, 1, 5);
+                    e.price = best_bid - depth;
                 }
             } else {  // Ask side
-                if (roll < static_cast<int>(improve_prob * 100) && (best_ask - tick > best_bid)) {
-                    e.price = best_ask - tick;
+                if (roll < static_cast<int>(improve_prob * 100) && (best_ask - 1 > best_bid)) {
+                    e.price = best_ask - 1;
                 } else if (roll < static_cast<int>((improve_prob + join_prob) * 100)) {
                     e.price = best_ask;
                 } else {
-                    int depth = depth_dist(rng);
-                    e.price = best_ask + depth * tick;
+                    int depth = rng::uniform_int(place_rng, 1, 5);
+                    e.price = best_ask + depth;
                 }
             }
         } else if (e.type == EventType::Cancel) {
             e.price = (e.side == Side::Bid) ? best_bid : best_ask;
         } else { // Market
-            e.price = 0.0;
+            e.price = 0;
         }
 
         // Apply event
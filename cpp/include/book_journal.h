@@ -0,0 +1,189 @@
+#pragma once
+
+#include "event.h"
+#include "event_buffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Compact binary journal of the events a book applied, with a full depth
+// snapshot every K events.
+//
+// Attach it with OrderBook::set_journal(): the book's current levels become
+// snapshot 0, and every accepted apply() is appended as a 16-byte
+// PackedEvent. begin_auction() and uncross() are recorded as phase changes
+// at the event index they happened after, and snapshots carry the phase and
+// the auction interest collected so far. seek() rebuilds the book as of any
+// event index from the nearest earlier snapshot, replaying at most K - 1
+// events and the phase changes among them. events() is an EventBuffer, so a
+// saved journal also serves as replay input for apply_batch() benchmarks.
+//
+// The file format is the in-memory columns written raw (host byte order).
+class BookJournal {
+public:
+    explicit BookJournal(std::size_t snapshot_every = 4096);
+
+    std::size_t snapshot_every() const { return every_; }
+    std::size_t size() const { return events_.size(); }
+    std::size_t snapshot_count() const { return snapshots_.size(); }
+    std::size_t phase_change_count() const { return changes_.size(); }
+    double tick_size() const { return tick_size_; }
+
+    const EventBuffer& events() const { return events_; }
+
+    void clear();
+
+    // Writer side, used by OrderBook
+    template <typename Book>
+    void start(const Book& book);
+    template <typename Book>
+    void record(const Event& e, const Book& book);
+    void record_begin_auction() { changes_.push_back({events_.size(), 0.0, 0, kBeginAuction}); }
+    void record_uncross(double t, Tick reference)
+    {
+        changes_.push_back({events_.size(), t, reference, kUncross});
+    }
+
+    // Puts `book` in the state it had after the first `index` journaled
+    // events and the phase changes recorded up to then (0 <= index <=
+    // size()). Any journal attached to `book` is detached first, so the
+    // replay is not recorded again. Returns false if index is out of range,
+    // nothing was recorded, or the book's tick size differs from the
+    // journal's.
+    template <typename Book>
+    bool seek(std::size_t index, Book& book) const;
+
+    bool save(const std::string& path) const;
+
+    // Returns false (leaving the journal untouched) if the file is not a
+    // journal or its counts do not match its size
+    bool load(const std::string& path);
+
+private:
+    struct Snapshot {
+        std::uint64_t index = 0;      // events applied before the snapshot
+        std::uint64_t offset = 0;     // first level in level_price_/level_qty_
+        std::uint32_t bid_count = 0;  // bids first (best first), then asks
+        std::uint32_t ask_count = 0;
+        std::int64_t auction_buy = 0; // Market interest collected in Auction
+        std::int64_t auction_sell = 0;
+        std::uint32_t phase = 0;      // BookPhase, as its underlying value
+        std::uint32_t reserved = 0;
+    };
+
+    static constexpr std::uint32_t kBeginAuction = 0;
+    static constexpr std::uint32_t kUncross = 1;
+
+    struct PhaseChange {
+        std::uint64_t index = 0;      // events applied before the change
+        double t = 0.0;               // uncross() arguments
+        Tick reference = 0;
+        std::uint32_t kind = kBeginAuction;
+        std::uint32_t reserved = 0;
+    };
+
+    std::size_t every_;
+    double tick_size_ = 0.1;
+
+    EventBuffer events_;
+    std::vector<Snapshot> snapshots_;
+    std::vector<PhaseChange> changes_;   // in recording order
+    std::vector<Tick> level_price_;
+    std::vector<int> level_qty_;
+
+    template <typename Book>
+    void take_snapshot(const Book& book);
+};
+
+template <typename Book>
+void BookJournal::start(const Book& book)
+{
+    clear();
+    tick_size_ = book.tick_size();
+    take_snapshot(book);
+}
+
+template <typename Book>
+void BookJournal::record(const Event& e, const Book& book)
+{
+    events_.push(e);
+    if (events_.size() % every_ == 0) take_snapshot(book);
+}
+
+template <typename Book>
+void BookJournal::take_snapshot(const Book& book)
+{
+    Snapshot s;
+    s.index = events_.size();
+    s.offset = level_price_.size();
+    s.bid_count = static_cast<std::uint32_t>(book.bid_levels());
+    s.ask_count = static_cast<std::uint32_t>(book.ask_levels());
+    s.auction_buy = book.auction_interest(Side::Bid);
+    s.auction_sell = book.auction_interest(Side::Ask);
+    s.phase = static_cast<std::uint32_t>(book.phase());
+
+    const std::size_t total = s.bid_count + s.ask_count;
+    level_price_.resize(s.offset + total);
+    level_qty_.resize(s.offset + total);
+
+    Tick* px = level_price_.data() + s.offset;
+    int* qty = level_qty_.data() + s.offset;
+    book.depth(Side::Bid, px, qty, s.bid_count);
+    book.depth(Side::Ask, px + s.bid_count, qty + s.bid_count, s.ask_count);
+
+    snapshots_.push_back(s);
+}
+
+template <typename Book>
+bool BookJournal::seek(std::size_t index, Book& book) const
+{
+    if (snapshots_.empty() || index > events_.size()) return false;
+    if (book.tick_size() != tick_size_) return false;
+
+    // Snapshot k was taken after k * every_ events
+    const Snapshot& s = snapshots_[std::min(index / every_, snapshots_.size() - 1)];
+
+    book.set_journal(nullptr);
+    book.clear();   // keeps the book's window bound and depth index
+    for (std::uint32_t i = 0; i < s.bid_count + s.ask_count; ++i) {
+        const Side side = (i < s.bid_count) ? Side::Bid : Side::Ask;
+        book.apply_delta({0.0, level_price_[s.offset + i], level_qty_[s.offset + i], side});
+    }
+
+    // Collected auction interest goes back in as the Market orders it came from
+    if (s.phase != 0) {
+        book.begin_auction();
+        for (const Side side : {Side::Bid, Side::Ask}) {
+            Event e;
+            e.type = EventType::Market;
+            e.side = side;
+            for (std::int64_t left = side == Side::Bid ? s.auction_buy : s.auction_sell; left > 0;
+                 left -= e.quantity) {
+                e.quantity = static_cast<int>(
+                    std::min<std::int64_t>(left, std::numeric_limits<int>::max()));
+                book.apply(e);
+            }
+        }
+    }
+
+    // Changes at the snapshot's own index were recorded after it was taken
+    auto change = std::lower_bound(
+        changes_.begin(), changes_.end(), s.index,
+        [](const PhaseChange& c, std::uint64_t i) { return c.index < i; });
+    for (std::size_t i = s.index;; ++i) {
+        for (; change != changes_.end() && change->index == i; ++change) {
+            if (change->kind == kBeginAuction) {
+                book.begin_auction();
+            } else {
+                book.uncross(change->t, change->reference);
+            }
+        }
+        if (i == index) break;
+        book.apply(events_[i]);
+    }
+    return true;
+}
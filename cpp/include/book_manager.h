@@ -0,0 +1,74 @@
+#pragma once
+
+#include "event.h"
+#include "order_book.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Owns one OrderBook per instrument, keyed by a dense InstrumentId.
+//
+// The books themselves are an array of structs (one full OrderBook per
+// instrument, each with its own ladders); only the top of book is laid out
+// column-wise. Best bid/ask and their quantities are mirrored in
+// struct-of-arrays columns, so cross-sectional reads (all mids, all spreads,
+// ...) are linear scans over contiguous memory instead of a walk over the
+// books.
+//
+// The columns are refreshed lazily: apply() only marks the instrument, and
+// the next column read syncs the instruments touched since the last one.
+// Callers that never read the columns pay one flag check per event.
+class BookManager {
+public:
+    explicit BookManager(std::size_t expected_instruments = 0);
+
+    // Registers a new instrument and returns its ID (0, 1, 2, ...)
+    InstrumentId add_instrument(double tick_size);
+
+    std::size_t size() const { return books_.size(); }
+
+    // Routes by e.instrument; unknown instruments are rejected
+    bool apply(const Event& e);
+    std::size_t apply_batch(const Event* events, std::size_t n);
+
+    const OrderBook& book(InstrumentId id) const { return books_[id]; }
+
+    // SoA columns, one entry per instrument (empty side = tick 0 / qty 0)
+    const std::vector<Tick>& best_bids() const { sync(); return best_bid_; }
+    const std::vector<Tick>& best_asks() const { sync(); return best_ask_; }
+    const std::vector<int>& best_bid_qtys() const { sync(); return bid_qty_; }
+    const std::vector<int>& best_ask_qtys() const { sync(); return ask_qty_; }
+
+    // Cross-sectional reads into caller arrays of length size().
+    // Instruments without a two-sided book get NaN.
+    void mids(double* out) const;
+    void spreads(double* out) const;
+    void imbalances(double* out) const;
+
+private:
+    std::vector<OrderBook> books_;
+
+    std::vector<double> tick_size_;
+
+    // Mirrored top of book, brought up to date by sync() on read
+    mutable std::vector<Tick> best_bid_;
+    mutable std::vector<Tick> best_ask_;
+    mutable std::vector<int> bid_qty_;
+    mutable std::vector<int> ask_qty_;
+
+    // Instruments changed since the last sync(), each listed once
+    mutable std::vector<InstrumentId> dirty_;
+    mutable std::vector<std::uint8_t> is_dirty_;
+
+    void mark(InstrumentId id)
+    {
+        if (!is_dirty_[id]) {
+            is_dirty_[id] = 1;
+            dirty_.push_back(id);
+        }
+    }
+
+    void sync() const;
+    void refresh(InstrumentId id) const;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "event.h"
+#include "event_buffer.h"
 #include "order_book.h"
 
 #include <fstream>
@@ -9,15 +10,23 @@
 
 class CsvLogger {
 public:
-    explicit CsvLogger(const std::string& path);
+    // tick_size converts tick prices to prices when rows are written
+    CsvLogger(const std::string& path, double tick_size);
 
     bool is_open() const;
     void write_header();
     void log(double t, const Event& e, const TopOfBook& tob, const Metrics& m);
 
+    // One row per buffered event, with book state taken from the columns an
+    // OrderBook::apply_batch() pass wrote (same layout as log()). Null series
+    // columns, empty sides and NaN metrics are written as empty fields.
+    void log_batch(const EventBuffer& events, const BookSeries& series);
+
 private:
     std::ofstream out_;
+    double tick_size_;
 
+    std::string opt_price(const std::optional<Tick>& x) const;
     static std::string opt_num(const std::optional<double>& x);
     static std::string opt_int(const std::optional<int>& x);
 };
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fenwick (binary indexed) tree over the positions of a price window, holding
+// quantity and notional (price * quantity, in ticks) per position.
+//
+// Position 0 is the side's most aggressive tick, so prefix sums run from the
+// touch outward. update(), prefix_qty() and lower_bound() are O(log size).
+// The size must be a power of two.
+class DepthIndex {
+public:
+    // Zero the index for `size` positions (reuses storage when it fits)
+    void reset(std::size_t size);
+
+    // Bulk build: set_raw() each non-empty position, then finish_build() (O(size))
+    void set_raw(std::size_t pos, std::int64_t qty, std::int64_t notional)
+    {
+        qty_[pos + 1] = qty;
+        notional_[pos + 1] = notional;
+    }
+    void finish_build();
+
+    void update(std::size_t pos, std::int64_t dqty, std::int64_t dnotional);
+
+    // Sum of quantities over positions [0, pos]
+    std::int64_t prefix_qty(std::size_t pos) const;
+
+    // Smallest position whose prefix quantity reaches `target` (>= 1), along
+    // with the quantity and notional strictly before it. Returns size() if the
+    // whole window holds less than `target`.
+    std::size_t lower_bound(std::int64_t target,
+                            std::int64_t& qty_before,
+                            std::int64_t& notional_before) const;
+
+    std::size_t size() const { return size_; }
+
+private:
+    std::size_t size_ = 0;
+    std::vector<std::int64_t> qty_;        // 1-based Fenwick arrays
+    std::vector<std::int64_t> notional_;
+};
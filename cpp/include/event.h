@@ -1,5 +1,7 @@
 #pragma once
 
+#include "tick.h"
+
 #include <cstdint>
 
 // Which side of the book the event originates from
@@ -15,11 +17,15 @@ enum class EventType : std::uint8_t {
     Market      // aggressive order consuming opposite best
 };
 
-// A single order-book event
+// Dense instrument index used to route events to a book (see BookManager)
+using InstrumentId = std::uint16_t;
+
+// A single order-book event (24 bytes: widest fields first to avoid padding)
 struct Event {
     double t = 0.0;          // event time
+    Tick price = 0;          // price level in ticks (used for Add/Cancel)
+    int quantity = 0;        // order size
     EventType type{};        // Add / Cancel / Market
     Side side{};             // Bid or Ask (aggressor side for Market)
-    double price = 0.0;      // price level (used for Add/Cancel)
-    int quantity = 0;        // order size
+    InstrumentId instrument = 0;   // ignored by a single OrderBook
 };
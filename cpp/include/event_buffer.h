@@ -0,0 +1,66 @@
+#pragma once
+
+#include "event.h"
+#include "packed_event.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Columnar (SoA) store of packed events: one 64-bit stamp column (fixed-point
+// time plus type/side, see PackedEvent) and 32-bit price and quantity
+// columns, 16 bytes per event in total. Consumers that only need one field
+// (e.g. times for inter-arrival statistics) stream just that column.
+//
+// Processes fill it through EventProcess::generate(), OrderBook::apply_batch()
+// replays it, and CsvLogger::log_batch() writes it out.
+class EventBuffer {
+public:
+    explicit EventBuffer(std::size_t capacity = 0) { reserve(capacity); }
+
+    void reserve(std::size_t n)
+    {
+        stamp_.reserve(n);
+        price_.reserve(n);
+        qty_.reserve(n);
+    }
+
+    // Keeps capacity, so a buffer reused across batches does not allocate
+    void clear()
+    {
+        stamp_.clear();
+        price_.clear();
+        qty_.clear();
+    }
+
+    std::size_t size() const { return stamp_.size(); }
+    bool empty() const { return stamp_.empty(); }
+
+    void push(const PackedEvent& p)
+    {
+        stamp_.push_back(p.stamp);
+        price_.push_back(p.price);
+        qty_.push_back(p.qty);
+    }
+    void push(const Event& e) { push(pack(e)); }
+
+    PackedEvent packed(std::size_t i) const
+    {
+        PackedEvent p;
+        p.stamp = stamp_[i];
+        p.price = price_[i];
+        p.qty = qty_[i];
+        return p;
+    }
+    Event operator[](std::size_t i) const { return unpack(packed(i)); }
+
+    // Raw columns
+    const std::uint64_t* stamps() const { return stamp_.data(); }
+    const std::int32_t* prices() const { return price_.data(); }
+    const std::int32_t* quantities() const { return qty_.data(); }
+
+private:
+    std::vector<std::uint64_t> stamp_;
+    std::vector<std::int32_t> price_;
+    std::vector<std::int32_t> qty_;
+};
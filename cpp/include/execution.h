@@ -0,0 +1,90 @@
+#pragma once
+
+#include "event.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One price level swept by an aggressive order
+struct Fill {
+    Tick price = 0;
+    int qty = 0;
+};
+
+// Summary of one aggressive order (Market, or marketable limit)
+struct Execution {
+    double t = 0.0;
+    Side aggressor{};              // Bid = buyer lifting asks, Ask = seller hitting bids
+    int requested = 0;
+    int filled = 0;
+    int residual = 0;              // requested - filled (book ran dry)
+    int levels = 0;                // price levels touched
+    Tick arrival = 0;              // opposite best before execution (0 if side was empty)
+    std::int64_t notional = 0;     // sum(price * qty), in ticks
+    std::uint32_t first_fill = 0;  // index of this order's first Fill in the sink
+
+    double vwap_ticks() const
+    {
+        return filled > 0 ? static_cast<double>(notional) / filled : 0.0;
+    }
+
+    // Cost versus the arrival best, in ticks (positive = paid through the touch)
+    double slippage_ticks() const
+    {
+        if (filled == 0) return 0.0;
+        const double d = vwap_ticks() - static_cast<double>(arrival);
+        return aggressor == Side::Bid ? d : -d;
+    }
+};
+
+// Reusable, preallocated buffer the book writes execution reports into.
+// Capacity is reserved up front and kept across clear(), so a sink that is
+// cleared between batches never allocates on the event path.
+class FillSink {
+public:
+    explicit FillSink(std::size_t fill_capacity = 4096, std::size_t execution_capacity = 1024)
+    {
+        fills_.reserve(fill_capacity);
+        executions_.reserve(execution_capacity);
+    }
+
+    void clear()
+    {
+        fills_.clear();
+        executions_.clear();
+    }
+
+    const std::vector<Fill>& fills() const { return fills_; }
+    const std::vector<Execution>& executions() const { return executions_; }
+
+    // Fills belonging to executions()[i] are fills()[first_fill, first_fill + levels)
+    const Fill* fills_of(const Execution& x) const { return fills_.data() + x.first_fill; }
+
+    // Writer side, used by OrderBook
+    Execution& begin(double t, Side aggressor, int requested, Tick arrival)
+    {
+        Execution x{};
+        x.t = t;
+        x.aggressor = aggressor;
+        x.requested = requested;
+        x.residual = requested;
+        x.arrival = arrival;
+        x.first_fill = static_cast<std::uint32_t>(fills_.size());
+        executions_.push_back(x);
+        return executions_.back();
+    }
+
+    void record(Execution& x, Tick price, int qty)
+    {
+        fills_.push_back({price, qty});
+        x.filled += qty;
+        x.residual -= qty;
+        x.levels += 1;
+        x.notional += static_cast<std::int64_t>(price) * qty;
+    }
+
+private:
+    std::vector<Fill> fills_;
+    std::vector<Execution> executions_;
+};
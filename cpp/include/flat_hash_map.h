@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Open-addressing hash map for integer keys (order IDs, tick prices).
+//
+// Linear probing over a power-of-two table with backward-shift deletion, so
+// there are no tombstones and lookups stay short. Storage is a single
+// contiguous vector: once reserved, insert/erase never allocate.
+//
+// Pointers returned by find()/insert() are invalidated by the next insert that
+// grows the table.
+template <typename Key, typename Value>
+class FlatHashMap {
+public:
+    explicit FlatHashMap(std::size_t expected = 16) { reserve(expected); }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    void reserve(std::size_t expected)
+    {
+        std::size_t cap = 16;
+        while (cap < expected * 2) cap *= 2;  // keep load factor <= 0.5
+        if (cap > slots_.size()) rehash(cap);
+    }
+
+    Value* find(Key key)
+    {
+        std::size_t i = home(key);
+        while (slots_[i].used) {
+            if (slots_[i].key == key) return &slots_[i].value;
+            i = (i + 1) & mask_;
+        }
+        return nullptr;
+    }
+
+    const Value* find(Key key) const
+    {
+        return const_cast<FlatHashMap*>(this)->find(key);
+    }
+
+    // Inserts a value-initialised entry if key is absent
+    Value& operator[](Key key)
+    {
+        if ((size_ + 1) * 2 > slots_.size()) rehash(slots_.size() * 2);
+
+        std::size_t i = home(key);
+        while (slots_[i].used) {
+            if (slots_[i].key == key) return slots_[i].value;
+            i = (i + 1) & mask_;
+        }
+        slots_[i].used = true;
+        slots_[i].key = key;
+        slots_[i].value = Value{};
+        ++size_;
+        return slots_[i].value;
+    }
+
+    bool erase(Key key)
+    {
+        std::size_t i = home(key);
+        while (slots_[i].used && slots_[i].key != key) i = (i + 1) & mask_;
+        if (!slots_[i].used) return false;
+
+        // Backward-shift: pull later entries of the probe run into the hole
+        std::size_t j = i;
+        while (true) {
+            j = (j + 1) & mask_;
+            if (!slots_[j].used) break;
+            const std::size_t k = home(slots_[j].key);
+            const bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+            if (!stays) {
+                slots_[i] = std::move(slots_[j]);
+                i = j;
+            }
+        }
+        slots_[i].used = false;
+        --size_;
+        return true;
+    }
+
+    void clear()
+    {
+        for (auto& s : slots_) s.used = false;
+        size_ = 0;
+    }
+
+private:
+    struct Slot {
+        Key key{};
+        Value value{};
+        bool used = false;
+    };
+
+    std::vector<Slot> slots_;
+    std::size_t mask_ = 0;
+    unsigned shift_ = 64;
+    std::size_t size_ = 0;
+
+    std::size_t home(Key key) const
+    {
+        // Fibonacci hashing: one multiply, high bits select the slot
+        const std::uint64_t x = static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<std::size_t>(x >> shift_);
+    }
+
+    void rehash(std::size_t cap)
+    {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        slots_.assign(cap, Slot{});
+        mask_ = cap - 1;
+        shift_ = 64;
+        for (std::size_t c = cap; c > 1; c >>= 1) --shift_;
+        size_ = 0;
+        for (auto& s : old) {
+            if (s.used) (*this)[s.key] = std::move(s.value);
+        }
+    }
+};
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+// GCC 12's AVX-512 intrinsics trip -Wuninitialized on their own placeholders
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+// Vector kernels for the exponential-kernel Hawkes state.
+//
+// All arrays are 64-byte aligned and padded to a multiple of kLanes with
+// zeros (mu = s = lambda = beta = 0 in the padding), so every loop runs in
+// whole vectors and padding lanes stay at lambda = 0. The scalar fallback
+// needs no padding (kLanes = 1).
+//
+// The AVX-512 or AVX2 path is picked at compile time from the target
+// (configure with -DLOB_ENABLE_NATIVE=ON to build for the host CPU);
+// otherwise plain loops are used, which the compiler may vectorize itself.
+namespace hawkes_kernels {
+
+#if defined(__AVX512F__)
+inline constexpr std::size_t kLanes = 8;
+#elif defined(__AVX2__)
+inline constexpr std::size_t kLanes = 4;
+#else
+inline constexpr std::size_t kLanes = 1;
+#endif
+
+inline constexpr std::size_t kAlign = 64;
+
+inline constexpr std::size_t padded(std::size_t n)
+{
+    return (n + kLanes - 1) / kLanes * kLanes;
+}
+
+// Minimal allocator giving std::vector cache-line aligned storage
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{kAlign}));
+    }
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t{kAlign});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U>&) const noexcept { return false; }
+};
+
+// Vector exp(x) for x <= 0 (decay factors): Cody-Waite reduction
+// x = k*ln2 + r, |r| <= ln2/2, and a degree-12 Taylor polynomial for exp(r).
+// Relative error < 1e-15 for x >= kExpMin; below it (exp(x) < 3e-308) the
+// result is 0, and x > 0 is clamped to 0 (result 1) so a stray positive
+// argument cannot overflow the exponent bits. The scalar fallback uses
+// std::exp.
+inline constexpr double kExpMin = -708.0;
+
+namespace detail {
+
+inline constexpr double kLog2e = 1.4426950408889634;
+inline constexpr double kLn2Hi = 0.693145751953125;
+inline constexpr double kLn2Lo = 1.42860682030941723212e-6;
+inline constexpr double kRound = 6755399441055744.0;   // 1.5 * 2^52
+
+// 1/12!, 1/11!, ..., 1/0!
+inline constexpr double kPoly[13] = {
+    2.08767569878680989792e-9, 2.50521083854417187751e-8, 2.75573192239858906526e-7,
+    2.75573192239858906526e-6, 2.48015873015873015873e-5, 1.98412698412698412698e-4,
+    1.38888888888888888889e-3, 8.33333333333333333333e-3, 4.16666666666666666667e-2,
+    1.66666666666666666667e-1, 0.5, 1.0, 1.0,
+};
+
+}  // namespace detail
+
+#if defined(__AVX512F__)
+
+inline __m512d exp_neg(__m512d x)
+{
+    using namespace detail;
+    const __mmask8 live = _mm512_cmp_pd_mask(x, _mm512_set1_pd(kExpMin), _CMP_GE_OQ);
+    x = _mm512_min_pd(_mm512_max_pd(x, _mm512_set1_pd(kExpMin)), _mm512_setzero_pd());
+
+    const __m512d round = _mm512_set1_pd(kRound);
+    const __m512d t = _mm512_add_pd(_mm512_mul_pd(x, _mm512_set1_pd(kLog2e)), round);
+    const __m512d k = _mm512_sub_pd(t, round);
+    const __m512d r = _mm512_sub_pd(_mm512_sub_pd(x, _mm512_mul_pd(k, _mm512_set1_pd(kLn2Hi))),
+                                    _mm512_mul_pd(k, _mm512_set1_pd(kLn2Lo)));
+
+    __m512d p = _mm512_set1_pd(kPoly[0]);
+    for (int j = 1; j < 13; ++j) p = _mm512_add_pd(_mm512_mul_pd(p, r), _mm512_set1_pd(kPoly[j]));
+
+    // The low mantissa bits of t hold k; k + 1023 shifted into the exponent is 2^k
+    const __m512i biased = _mm512_add_epi64(_mm512_castpd_si512(t), _mm512_set1_epi64(1023));
+    const __m512d scale = _mm512_castsi512_pd(_mm512_slli_epi64(biased, 52));
+    return _mm512_maskz_mul_pd(live, p, scale);
+}
+
+#elif defined(__AVX2__)
+
+inline __m256d exp_neg(__m256d x)
+{
+    using namespace detail;
+    const __m256d live = _mm256_cmp_pd(x, _mm256_set1_pd(kExpMin), _CMP_GE_OQ);
+    x = _mm256_min_pd(_mm256_max_pd(x, _mm256_set1_pd(kExpMin)), _mm256_setzero_pd());
+
+    const __m256d round = _mm256_set1_pd(kRound);
+    const __m256d t = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(kLog2e)), round);
+    const __m256d k = _mm256_sub_pd(t, round);
+    const __m256d r = _mm256_sub_pd(_mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(kLn2Hi))),
+                                    _mm256_mul_pd(k, _mm256_set1_pd(kLn2Lo)));
+
+    __m256d p = _mm256_set1_pd(kPoly[0]);
+    for (int j = 1; j < 13; ++j) p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(kPoly[j]));
+
+    // The low mantissa bits of t hold k; k + 1023 shifted into the exponent is 2^k
+    const __m256i biased = _mm256_add_epi64(_mm256_castpd_si256(t), _mm256_set1_epi64x(1023));
+    const __m256d scale = _mm256_castsi256_pd(_mm256_slli_epi64(biased, 52));
+    return _mm256_and_pd(live, _mm256_mul_pd(p, scale));
+}
+
+#endif
+
+// s[i] *= exp(-beta[i] * dt); lambda[i] = max(mu[i] + s[i], 0)
+inline void decay(double* s, double* lambda, const double* mu, const double* beta,
+                  double dt, std::size_t n)
+{
+#if defined(__AVX512F__)
+    const __m512d ndt = _mm512_set1_pd(-dt);
+    const __m512d zero = _mm512_setzero_pd();
+    for (std::size_t i = 0; i < n; i += 8) {
+        const __m512d f = exp_neg(_mm512_mul_pd(_mm512_load_pd(beta + i), ndt));
+        const __m512d si = _mm512_mul_pd(_mm512_load_pd(s + i), f);
+        _mm512_store_pd(s + i, si);
+        _mm512_store_pd(lambda + i, _mm512_max_pd(_mm512_add_pd(_mm512_load_pd(mu + i), si), zero));
+    }
+#elif defined(__AVX2__)
+    const __m256d ndt = _mm256_set1_pd(-dt);
+    const __m256d zero = _mm256_setzero_pd();
+    for (std::size_t i = 0; i < n; i += 4) {
+        const __m256d f = exp_neg(_mm256_mul_pd(_mm256_load_pd(beta + i), ndt));
+        const __m256d si = _mm256_mul_pd(_mm256_load_pd(s + i), f);
+        _mm256_store_pd(s + i, si);
+        _mm256_store_pd(lambda + i, _mm256_max_pd(_mm256_add_pd(_mm256_load_pd(mu + i), si), zero));
+    }
+#else
+    for (std::size_t i = 0; i < n; ++i) {
+        s[i] *= std::exp(-beta[i] * dt);
+        const double l = mu[i] + s[i];
+        lambda[i] = l > 0.0 ? l : 0.0;
+    }
+#endif
+}
+
+// s[i] += col[i]; lambda[i] = max(mu[i] + s[i], 0)
+inline void excite(double* s, double* lambda, const double* mu, const double* col, std::size_t n)
+{
+#if defined(__AVX512F__)
+    const __m512d zero = _mm512_setzero_pd();
+    for (std::size_t i = 0; i < n; i += 8) {
+        const __m512d si = _mm512_add_pd(_mm512_load_pd(s + i), _mm512_load_pd(col + i));
+        _mm512_store_pd(s + i, si);
+        _mm512_store_pd(lambda + i, _mm512_max_pd(_mm512_add_pd(_mm512_load_pd(mu + i), si), zero));
+    }
+#elif defined(__AVX2__)
+    const __m256d zero = _mm256_setzero_pd();
+    for (std::size_t i = 0; i < n; i += 4) {
+        const __m256d si = _mm256_add_pd(_mm256_load_pd(s + i), _mm256_load_pd(col + i));
+        _mm256_store_pd(s + i, si);
+        _mm256_store_pd(lambda + i, _mm256_max_pd(_mm256_add_pd(_mm256_load_pd(mu + i), si), zero));
+    }
+#else
+    for (std::size_t i = 0; i < n; ++i) {
+        s[i] += col[i];
+        const double l = mu[i] + s[i];
+        lambda[i] = l > 0.0 ? l : 0.0;
+    }
+#endif
+}
+
+// Per-pair state, column-major with column stride n (column j = source j):
+// pairs[j][i] *= exp(-beta[j][i] * dt); s[i] = sum_j pairs[j][i];
+// lambda[i] = max(mu[i] + s[i], 0)
+inline void decay_pairs(double* pairs, double* s, double* lambda, const double* mu,
+                        const double* beta, double dt, std::size_t n, std::size_t cols)
+{
+#if defined(__AVX512F__)
+    const __m512d ndt = _mm512_set1_pd(-dt);
+    const __m512d zero = _mm512_setzero_pd();
+    for (std::size_t i = 0; i < n; i += 8) {
+        __m512d acc = zero;
+        for (std::size_t j = 0; j < cols; ++j) {
+            double* p = pairs + j * n + i;
+            const __m512d f = exp_neg(_mm512_mul_pd(_mm512_load_pd(beta + j * n + i), ndt));
+            const __m512d v = _mm512_mul_pd(_mm512_load_pd(p), f);
+            _mm512_store_pd(p, v);
+            acc = _mm512_add_pd(acc, v);
+        }
+        _mm512_store_pd(s + i, acc);
+        _mm512_store_pd(lambda + i, _mm512_max_pd(_mm512_add_pd(_mm512_load_pd(mu + i), acc), zero));
+    }
+#elif defined(__AVX2__)
+    const __m256d ndt = _mm256_set1_pd(-dt);
+    const __m256d zero = _mm256_setzero_pd();
+    for (std::size_t i = 0; i < n; i += 4) {
+        __m256d acc = zero;
+        for (std::size_t j = 0; j < cols; ++j) {
+            double* p = pairs + j * n + i;
+            const __m256d f = exp_neg(_mm256_mul_pd(_mm256_load_pd(beta + j * n + i), ndt));
+            const __m256d v = _mm256_mul_pd(_mm256_load_pd(p), f);
+            _mm256_store_pd(p, v);
+            acc = _mm256_add_pd(acc, v);
+        }
+        _mm256_store_pd(s + i, acc);
+        _mm256_store_pd(lambda + i, _mm256_max_pd(_mm256_add_pd(_mm256_load_pd(mu + i), acc), zero));
+    }
+#else
+    for (std::size_t i = 0; i < n; ++i) {
+        double acc = 0.0;
+        for (std::size_t j = 0; j < cols; ++j) {
+            double& p = pairs[j * n + i];
+            p *= std::exp(-beta[j * n + i] * dt);
+            acc += p;
+        }
+        s[i] = acc;
+        const double l = mu[i] + acc;
+        lambda[i] = l > 0.0 ? l : 0.0;
+    }
+#endif
+}
+
+// dst[i] += src[i]
+inline void accumulate(double* dst, const double* src, std::size_t n)
+{
+#if defined(__AVX512F__)
+    for (std::size_t i = 0; i < n; i += 8) {
+        _mm512_store_pd(dst + i, _mm512_add_pd(_mm512_load_pd(dst + i), _mm512_load_pd(src + i)));
+    }
+#elif defined(__AVX2__)
+    for (std::size_t i = 0; i < n; i += 4) {
+        _mm256_store_pd(dst + i, _mm256_add_pd(_mm256_load_pd(dst + i), _mm256_load_pd(src + i)));
+    }
+#else
+    for (std::size_t i = 0; i < n; ++i) dst[i] += src[i];
+#endif
+}
+
+// sum of w[i] * lambda[i] over lambda[i] > 0
+inline double weighted_total(const double* w, const double* lambda, std::size_t n)
+{
+#if defined(__AVX512F__)
+    __m512d acc = _mm512_setzero_pd();
+    for (std::size_t i = 0; i < n; i += 8) {
+        const __m512d l = _mm512_load_pd(lambda + i);
+        const __mmask8 pos = _mm512_cmp_pd_mask(l, _mm512_setzero_pd(), _CMP_GT_OQ);
+        acc = _mm512_mask_add_pd(acc, pos, acc, _mm512_mul_pd(_mm512_load_pd(w + i), l));
+    }
+    return _mm512_reduce_add_pd(acc);
+#elif defined(__AVX2__)
+    __m256d acc = _mm256_setzero_pd();
+    for (std::size_t i = 0; i < n; i += 4) {
+        const __m256d l = _mm256_load_pd(lambda + i);
+        const __m256d pos = _mm256_cmp_pd(l, _mm256_setzero_pd(), _CMP_GT_OQ);
+        acc = _mm256_add_pd(acc, _mm256_and_pd(pos, _mm256_mul_pd(_mm256_load_pd(w + i), l)));
+    }
+    const __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+#else
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (lambda[i] > 0.0) sum += w[i] * lambda[i];
+    }
+    return sum;
+#endif
+}
+
+}  // namespace hawkes_kernels
@@ -2,46 +2,389 @@
 
 #include "process.h"
 #include "event.h"
+#include "hawkes_kernels.h"
+#include "random_buffer.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
-#include <random>
 
-class HawkesMultivariateProcess : public EventProcess {
+// What an event of one Hawkes dimension means for the book
+struct EventMapping {
+    EventType type;
+    Side side;
+};
+
+// The classic 6-dimensional layout:
+// 0: Bid Add
+// 1: Ask Add
+// 2: Bid Cancel
+// 3: Ask Cancel
+// 4: Market Buy  (aggressor is buyer → consumes asks)
+// 5: Market Sell (aggressor is seller → consumes bids)
+inline constexpr std::array<EventMapping, 6> kDefaultEventMapping = {{
+    {EventType::Add, Side::Bid},
+    {EventType::Add, Side::Ask},
+    {EventType::Cancel, Side::Bid},
+    {EventType::Cancel, Side::Ask},
+    {EventType::Market, Side::Bid},
+    {EventType::Market, Side::Ask},
+}};
+
+// Multivariate Hawkes process with exponential kernels, simulated by Ogata
+// thinning on the state-weighted total intensity.
+//
+// Each dimension i has a baseline mu_i and lambda_i = mu_i + sum_j s_ij,
+// where an event in dimension j adds alpha(i, j) to s_ij and s_ij decays at
+// beta(i, j). The recursion is exact: with row-constant beta (one rate per
+// target i) the s_ij collapse into s_i = sum_j s_ij and only the N
+// aggregates are tracked; otherwise all N^2 pair states are, in a buffer
+// allocated once at construction.
+// The mapping table turns the firing dimension into an Event (type, side);
+// by default dimension i follows kDefaultEventMapping[i % 6], so a 12-D model
+// is two blocks of the classic layout (e.g. at-touch, then deep).
+//
+// State and parameters live in 64-byte aligned buffers padded to whole SIMD
+// vectors (see hawkes_kernels.h); alpha/beta are column-major so the jump
+// from dimension k reads one contiguous column.
+//
+// N = 0 sizes the process at construction. A non-zero N fixes the dimension
+// at compile time: the state lives in std::array and the vector loops have
+// constant trip counts, so they are fully unrolled.
+//
+// Rng is the random number policy (see rng.h); the default hands out
+// pre-drawn numbers (see random_buffer.h).
+template <std::size_t N = 0, typename Rng = BufferedRandom>
+class BasicHawkesMultivariateProcess : public EventProcess {
 public:
-    HawkesMultivariateProcess(
-        const std::vector<double>& mu,                     // size = 6
-        const std::vector<std::vector<double>>& alpha,     // 6 x 6
-        const std::vector<std::vector<double>>& beta,      // 6 x 6
+    static constexpr std::size_t kFixedDim = N;
+    using Generator = Rng;
+
+    BasicHawkesMultivariateProcess(
+        const std::vector<double>& mu,                     // size = dim
+        const std::vector<std::vector<double>>& alpha,     // dim x dim
+        const std::vector<std::vector<double>>& beta,      // dim x dim
         int qty_min,
         int qty_max,
-        unsigned seed = 42
+        unsigned seed = 42,
+        const std::vector<EventMapping>& mapping = {}      // empty = default
     );
 
+    std::size_t dim() const { return N ? N : dim_; }
+
     // Hybrid hook: state-dependent multiplicative weights w_i(X(t))
-    // Must be size 6, values > 0 recommended.
+    // One per dimension, values > 0 recommended.
     void set_weights(const std::vector<double>& w);
 
     Event next(double t) override;
 
-private:
+    const EventMapping& mapping(std::size_t k) const { return mapping_[k]; }
+
+    // Dimension that produced the last event from next()
+    std::size_t last_dimension() const { return last_dim_; }
+
+    // True when beta is not row-constant and per-pair state is tracked
+    bool pairwise() const { return pairwise_; }
+
+    // Candidate times drawn so far; events / proposals is the acceptance rate
+    std::uint64_t proposals() const { return proposals_; }
+
+    // Padded length of every per-dimension buffer
+    static constexpr std::size_t kStride = hawkes_kernels::padded(N);
+
+    // Fixed dimensions keep their state inline, runtime ones on the heap
+    using Vector = std::conditional_t<N != 0, std::array<double, kStride>,
+                                      std::vector<double, hawkes_kernels::AlignedAllocator<double>>>;
+    using Matrix = std::conditional_t<N != 0, std::array<double, kStride * N>,
+                                      std::vector<double, hawkes_kernels::AlignedAllocator<double>>>;
+
+    // Everything next() depends on besides the (fixed) parameters. Copying a
+    // State lets a warmed-up process be forked into many divergent paths.
+    struct State {
+        alignas(hawkes_kernels::kAlign) Vector s;
+        alignas(hawkes_kernels::kAlign) Vector lambda;
+        alignas(hawkes_kernels::kAlign) Vector w;
+        alignas(hawkes_kernels::kAlign) Matrix pairs;   // empty unless pairwise()
+        double last_time = 0.0;
+        Rng rng;
+    };
+
+    State state() const;
+    void restore(const State& st);   // reuses buffers: no allocation
+
+    // Re-seeds only the RNG, e.g. to make forked paths diverge
+    void reseed(unsigned seed) { rng_ = Rng(seed); }
+
+    // Or hands it a whole generator, e.g. a substream split off with jump()
+    void reseed(const Rng& rng) { rng_ = rng; }
+
+protected:
+    using Mapping = std::conditional_t<N != 0, std::array<EventMapping, N>,
+                                       std::vector<EventMapping>>;
+
     std::size_t dim_;
+    std::size_t stride_;   // padded(dim_)
 
-    std::vector<double> mu_;
-    std::vector<std::vector<double>> alpha_;
-    std::vector<std::vector<double>> beta_;
+    // column-major: alpha_[k * stride + i] = alpha(i, k); beta_ likewise
+    alignas(hawkes_kernels::kAlign) Matrix alpha_;
+    alignas(hawkes_kernels::kAlign) Matrix beta_;
+    alignas(hawkes_kernels::kAlign) Vector mu_;
+    alignas(hawkes_kernels::kAlign) Vector decay_;    // per-target rate (row-constant beta)
+    Mapping mapping_;
+    bool pairwise_ = false;
 
-    std::vector<double> s_;
-    std::vector<double> lambda_;
-    std::vector<double> w_;       // <--- NEW: state weights
+    alignas(hawkes_kernels::kAlign) Matrix pairs_;    // s_ij, same layout as beta_
+    alignas(hawkes_kernels::kAlign) Vector s_;        // sum_j s_ij
+    alignas(hawkes_kernels::kAlign) Vector lambda_;
+    alignas(hawkes_kernels::kAlign) Vector w_;        // state weights
 
     double last_time_;
+    std::size_t last_dim_ = 0;
+    std::uint64_t proposals_ = 0;
 
-    std::mt19937 rng_;
-    std::uniform_real_distribution<double> uni01_;
-    std::uniform_int_distribution<int> qty_dist_;
+    Rng rng_;
+    int qty_min_;
+    int qty_max_;
+
+    // Compile-time constant when the dimension is fixed
+    std::size_t stride() const { return N ? kStride : stride_; }
 
     void decay_to(double t);
+    void excite(std::size_t k);
+
+    // Applies the jump of an event in dimension k at the current state time
+    // and builds the Event for it
+    Event fire(std::size_t k, double t);
 
     double total_weighted_intensity() const;
     std::size_t sample_dimension_weighted();
 };
+
+// Runtime-dimension process used by the apps and bindings
+using HawkesMultivariateProcess = BasicHawkesMultivariateProcess<>;
+
+template <std::size_t N, typename Rng>
+BasicHawkesMultivariateProcess<N, Rng>::BasicHawkesMultivariateProcess(
+    const std::vector<double>& mu,
+    const std::vector<std::vector<double>>& alpha,
+    const std::vector<std::vector<double>>& beta,
+    int qty_min,
+    int qty_max,
+    unsigned seed,
+    const std::vector<EventMapping>& mapping
+)
+    : dim_(mu.size()),
+      stride_(hawkes_kernels::padded(mu.size())),
+      last_time_(0.0),
+      rng_(seed),
+      qty_min_(qty_min),
+      qty_max_(qty_max)
+{
+    if (dim_ == 0)
+        throw std::invalid_argument("Hawkes process needs at least one dimension");
+
+    if (N != 0 && dim_ != N)
+        throw std::invalid_argument("mu size does not match the fixed dimension");
+
+    if (alpha.size() != dim_ || beta.size() != dim_)
+        throw std::invalid_argument("alpha/beta matrices must be dim x dim");
+
+    for (std::size_t i = 0; i < dim_; ++i) {
+        if (alpha[i].size() != dim_ || beta[i].size() != dim_)
+            throw std::invalid_argument("alpha/beta rows must have one entry per dimension");
+    }
+
+    if (mapping.empty() && dim_ % kDefaultEventMapping.size() != 0)
+        throw std::invalid_argument("an event mapping is required unless dim is a multiple of 6");
+
+    if (!mapping.empty() && mapping.size() != dim_)
+        throw std::invalid_argument("event mapping must have one entry per dimension");
+
+    // Padding lanes stay at zero: no intensity, no excitation
+    if constexpr (N == 0) {
+        alpha_.assign(stride_ * dim_, 0.0);
+        beta_.assign(stride_ * dim_, 0.0);
+        mu_.assign(stride_, 0.0);
+        decay_.assign(stride_, 0.0);
+        mapping_.resize(dim_);
+        s_.assign(stride_, 0.0);
+        lambda_.assign(stride_, 0.0);
+        w_.assign(stride_, 0.0);
+    } else {
+        alpha_.fill(0.0);
+        beta_.fill(0.0);
+        mu_.fill(0.0);
+        decay_.fill(0.0);
+        s_.fill(0.0);
+        lambda_.fill(0.0);
+        w_.fill(0.0);
+        pairs_.fill(0.0);
+    }
+
+    for (std::size_t i = 0; i < dim_; ++i) {
+        if (!std::isfinite(mu[i]) || mu[i] <= 0.0)
+            throw std::invalid_argument("All baseline intensities mu must be finite and positive");
+        mu_[i] = mu[i];
+        lambda_[i] = mu[i];
+        w_[i] = 1.0;
+        decay_[i] = beta[i][0];
+        mapping_[i] = mapping.empty() ? kDefaultEventMapping[i % kDefaultEventMapping.size()]
+                                      : mapping[i];
+        for (std::size_t k = 0; k < dim_; ++k) {
+            if (!std::isfinite(beta[i][k]) || beta[i][k] <= 0.0)
+                throw std::invalid_argument("All decay rates beta must be finite and positive");
+            alpha_[k * stride() + i] = alpha[i][k];
+            beta_[k * stride() + i] = beta[i][k];
+            if (beta[i][k] != beta[i][0]) pairwise_ = true;
+        }
+    }
+
+    if constexpr (N == 0) {
+        if (pairwise_) pairs_.assign(stride_ * dim_, 0.0);
+    }
+}
+
+template <std::size_t N, typename Rng>
+void BasicHawkesMultivariateProcess<N, Rng>::set_weights(const std::vector<double>& w)
+{
+    if (w.size() != dim())
+        throw std::invalid_argument("weights vector must have one entry per dimension");
+
+    // Enforce strict positivity for thinning stability
+    for (std::size_t i = 0; i < dim(); ++i) {
+        w_[i] = (std::isfinite(w[i]) && w[i] > 0.0) ? w[i] : 1.0;
+    }
+}
+
+template <std::size_t N, typename Rng>
+typename BasicHawkesMultivariateProcess<N, Rng>::State BasicHawkesMultivariateProcess<N, Rng>::state() const
+{
+    return State{s_, lambda_, w_, pairs_, last_time_, rng_};
+}
+
+template <std::size_t N, typename Rng>
+void BasicHawkesMultivariateProcess<N, Rng>::restore(const State& st)
+{
+    if (st.s.size() != stride() || st.lambda.size() != stride() || st.w.size() != stride() ||
+        st.pairs.size() != pairs_.size())
+        throw std::invalid_argument("state dimension does not match process");
+
+    std::copy(st.s.begin(), st.s.end(), s_.begin());
+    std::copy(st.lambda.begin(), st.lambda.end(), lambda_.begin());
+    std::copy(st.w.begin(), st.w.end(), w_.begin());
+    std::copy(st.pairs.begin(), st.pairs.end(), pairs_.begin());
+    last_time_ = st.last_time;
+    rng_ = st.rng;
+}
+
+template <std::size_t N, typename Rng>
+void BasicHawkesMultivariateProcess<N, Rng>::decay_to(double t)
+{
+    if (t <= last_time_) return;
+
+    const double dt = t - last_time_;
+    if (pairwise_) {
+        hawkes_kernels::decay_pairs(pairs_.data(), s_.data(), lambda_.data(), mu_.data(),
+                                    beta_.data(), dt, stride(), dim());
+    } else {
+        hawkes_kernels::decay(s_.data(), lambda_.data(), mu_.data(), decay_.data(), dt, stride());
+    }
+    last_time_ = t;
+}
+
+template <std::size_t N, typename Rng>
+void BasicHawkesMultivariateProcess<N, Rng>::excite(std::size_t k)
+{
+    // Column k of alpha is contiguous
+    if (pairwise_) hawkes_kernels::accumulate(&pairs_[k * stride()], &alpha_[k * stride()], stride());
+    hawkes_kernels::excite(s_.data(), lambda_.data(), mu_.data(), &alpha_[k * stride()], stride());
+}
+
+template <std::size_t N, typename Rng>
+double BasicHawkesMultivariateProcess<N, Rng>::total_weighted_intensity() const
+{
+    return hawkes_kernels::weighted_total(w_.data(), lambda_.data(), stride());
+}
+
+template <std::size_t N, typename Rng>
+std::size_t BasicHawkesMultivariateProcess<N, Rng>::sample_dimension_weighted()
+{
+    const double total = total_weighted_intensity();
+
+    if (!(total > 0.0)) {
+        return 0;  // fallback — should rarely happen due to mu > 0
+    }
+
+    double u = rng::uniform01(rng_) * total;
+    double acc = 0.0;
+
+    for (std::size_t i = 0; i < dim(); ++i) {
+        if (lambda_[i] <= 0.0) continue;
+        acc += w_[i] * lambda_[i];
+        if (u <= acc) return i;
+    }
+
+    return dim() - 1;  // final fallback
+}
+
+template <std::size_t N, typename Rng>
+Event BasicHawkesMultivariateProcess<N, Rng>::fire(std::size_t k, double t)
+{
+    // Apply excitation from this event to all dimensions
+    excite(k);
+    last_dim_ = k;
+
+    Event e{};
+    e.t = t;
+    e.quantity = rng::uniform_int(rng_, qty_min_, qty_max_);
+    e.price = 0;  // Will be set by simulator for Add/Cancel
+    e.type = mapping_[k].type;
+    e.side = mapping_[k].side;
+    return e;
+}
+
+template <std::size_t N, typename Rng>
+Event BasicHawkesMultivariateProcess<N, Rng>::next(double t)
+{
+    decay_to(t);
+    double current_time = t;
+
+    while (true) {
+        const double lambda_bar = total_weighted_intensity();
+
+        if (!(lambda_bar > 0.0)) {
+            // Emergency fallback: reset weights to neutral and try again
+            std::fill_n(w_.begin(), dim(), 1.0);
+            continue;
+        }
+
+        // Propose candidate time
+        ++proposals_;
+        const double wait = rng::exponential(rng_, lambda_bar);
+        const double cand_time = current_time + wait;
+
+        // Decay state to candidate time
+        decay_to(cand_time);
+
+        const double lambda_cand = total_weighted_intensity();
+        const double u2 = rng::uniform01(rng_);
+
+        // Thinning acceptance
+        if (u2 <= lambda_cand / lambda_bar) {
+            // Accept: sample which dimension triggered the event
+            return fire(sample_dimension_weighted(), cand_time);
+        }
+
+        // Rejection: advance time but no excitation
+        current_time = cand_time;
+    }
+}
+
+// Compiled once in hawkes_multivariate_process.cpp
+extern template class BasicHawkesMultivariateProcess<>;
+extern template class BasicHawkesMultivariateProcess<6>;
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "process.h"
+#include "rng.h"
 #include <vector>
-#include <random>
 
 //Implements a mulvariate Hawkes process.
 class HawkesProcess : public EventProcess {
@@ -18,7 +18,7 @@ public:
     Event next(double t) override;
 private:
     // Random number generator
-    std::mt19937 rng_;
+    Xoshiro256pp rng_;
 
     //Number of event dimensions.
     std::size_t dim_;
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "process.h"
-#include <random>
+#include "random_buffer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
 
 // Univariate Hawkes process with exponential kernel.
 // Intensity: lambda(t) = mu + alpha * sum_{ti < t} exp(-beta * (t - ti))
@@ -13,9 +17,15 @@
 // This class generates full LOB Events by:
 //  - Hawkes for event times
 //  - simple distributions for side/type/qty/price (like PoissonProcess)
-class HawkesUnivariateProcess : public EventProcess {
+//
+// Rng is the random number policy (see rng.h); the default hands out
+// pre-drawn numbers (see random_buffer.h).
+template <typename Rng = BufferedRandom>
+class BasicHawkesUnivariateProcess : public EventProcess {
 public:
-    HawkesUnivariateProcess(
+    using Generator = Rng;
+
+    BasicHawkesUnivariateProcess(
         double mu,             // baseline intensity (>0)
         double alpha,          // excitation strength (>=0)
         double beta,           // decay rate (>0)
@@ -31,7 +41,27 @@ public:
     // Optional: expose intensity at current internal state (useful for debugging)
     double intensity() const;
 
-private:
+    // Checkpoint of the mutable state, for forking a warmed-up process
+    struct State {
+        double last_time = 0.0;
+        double s = 0.0;
+        Rng rng;
+    };
+
+    State state() const { return State{last_time_, s_, rng_}; }
+    void restore(const State& st)
+    {
+        last_time_ = st.last_time;
+        s_ = st.s;
+        rng_ = st.rng;
+    }
+    void reseed(unsigned seed) { rng_ = Rng(seed); }
+    void reseed(const Rng& rng) { rng_ = rng; }
+
+    // Candidate times drawn so far; events / proposals is the acceptance rate
+    std::uint64_t proposals() const { return proposals_; }
+
+protected:
     // Hawkes params
     double mu_;
     double alpha_;
@@ -41,17 +71,142 @@ private:
     double last_time_;  // last time we updated the state
     double s_;          // s(t) = sum exp(-beta*(t-ti)) at last_time_
 
-    // RNG and helper dists
-    std::mt19937 rng_;
-    std::uniform_real_distribution<double> uni01_;
-    std::uniform_int_distribution<int> qty_dist_;
-    std::bernoulli_distribution side_dist_;
-    std::bernoulli_distribution type_dist_;
+    // RNG and the quantity range
+    Rng rng_;
+    int qty_min_;
+    int qty_max_;
+
+    Tick price_center_;   // centre of the placement band, in ticks
 
-    double price_center_;
-    double tick_size_;
+    std::uint64_t proposals_ = 0;
 
-private:
     // Updates the internal state s_ from last_time_ to new_time assuming no event in-between
     void decay_to(double new_time);
+
+    // Side/type/qty/price for an event at time t (the jump is the caller's)
+    Event make_event(double t);
 };
+
+// Process used by the apps and bindings
+using HawkesUnivariateProcess = BasicHawkesUnivariateProcess<>;
+
+template <typename Rng>
+BasicHawkesUnivariateProcess<Rng>::BasicHawkesUnivariateProcess(
+    double mu,
+    double alpha,
+    double beta,
+    double price_center,
+    double tick_size,
+    int qty_min,
+    int qty_max,
+    unsigned seed
+)
+    : mu_(mu),
+      alpha_(alpha),
+      beta_(beta),
+      last_time_(0.0),
+      s_(0.0),
+      rng_(seed),
+      qty_min_(qty_min),
+      qty_max_(qty_max),
+      price_center_(to_ticks(price_center, tick_size))
+{
+    if (!(mu_ > 0.0))  throw std::invalid_argument("mu must be > 0");
+    if (alpha_ < 0.0)  throw std::invalid_argument("alpha must be >= 0");
+    if (!(beta_ > 0.0)) throw std::invalid_argument("beta must be > 0");
+}
+
+template <typename Rng>
+void BasicHawkesUnivariateProcess<Rng>::decay_to(double new_time)
+{
+    if (new_time < last_time_) {
+        // We expect monotone time in event simulation usage
+        last_time_ = new_time;
+        s_ = 0.0;
+        return;
+    }
+    const double dt = new_time - last_time_;
+    if (dt > 0.0) {
+        s_ *= std::exp(-beta_ * dt);
+        last_time_ = new_time;
+    }
+}
+
+template <typename Rng>
+double BasicHawkesUnivariateProcess<Rng>::intensity() const
+{
+    // Intensity at the internal "last_time_" state
+    return mu_ + alpha_ * s_;
+}
+
+template <typename Rng>
+Event BasicHawkesUnivariateProcess<Rng>::make_event(double t)
+{
+    // Now build a full Event (time from Hawkes; the rest simple like Poisson)
+    Event e{};
+    e.t = t;
+
+    e.side = rng::bernoulli(rng_, 0.5) ? Side::Bid : Side::Ask;
+    e.type = rng::bernoulli(rng_, 0.8) ? EventType::Add : EventType::Cancel;
+    e.quantity = rng::uniform_int(rng_, qty_min_, qty_max_);
+
+    // Minimal price model (we can improve later)
+    int tick_offset = 1 + (rng::uniform_int(rng_, qty_min_, qty_max_) % 5); // avoid 0 spread artifact
+    if (e.side == Side::Bid) {
+        e.price = price_center_ - tick_offset;
+    } else {
+        e.price = price_center_ + tick_offset;
+    }
+
+    return e;
+}
+
+template <typename Rng>
+Event BasicHawkesUnivariateProcess<Rng>::next(double t)
+{
+    // Ensure internal state is aligned to input time t
+    decay_to(t);
+
+    double current_time = t;
+
+    // Ogata thinning loop
+    while (true) {
+        const double lambda_bar = intensity(); // upper bound until next event
+
+        // Safety: lambda_bar should be positive
+        if (!(lambda_bar > 0.0) || !std::isfinite(lambda_bar)) {
+            // reset to baseline if something goes numerically wrong
+            s_ = 0.0;
+            last_time_ = current_time;
+        }
+
+        // Propose next candidate time from Exp(lambda_bar)
+        ++proposals_;
+        const double w = rng::exponential(rng_, lambda_bar);
+        const double cand_time = current_time + w;
+
+        // Compute intensity at candidate time (decayed since current_time)
+        // Note: between events, s decays; no jump unless event accepted.
+        const double dt = cand_time - last_time_;
+        const double s_cand = s_ * std::exp(-beta_ * dt);
+        const double lambda_cand = mu_ + alpha_ * s_cand;
+
+        // Accept with probability lambda_cand / lambda_bar
+        const double u2 = rng::uniform01(rng_);
+        if (u2 <= (lambda_cand / lambda_bar)) {
+            // Accept event at cand_time:
+            // First, decay state to cand_time, then add the jump contribution.
+            decay_to(cand_time);
+            s_ += 1.0; // event at cand_time contributes exp(0)=1 to s(t)
+
+            return make_event(cand_time);
+        } else {
+            // Reject: advance time to candidate, but no jump (no event)
+            decay_to(cand_time);
+            current_time = cand_time;
+        }
+    }
+}
+
+// Compiled once in hawkes_univariate_process.cpp
+extern template class BasicHawkesUnivariateProcess<>;
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "event.h"
+
+#include <cstddef>
+#include <vector>
+
+// Market-by-price update: "level `price` on `side` is now `qty`" (0 = removed)
+struct LevelDelta {
+    double t = 0.0;
+    Tick price = 0;
+    int qty = 0;
+    Side side{};
+};
+
+// Reusable buffer the book appends one LevelDelta to per level it touches.
+// Like FillSink, capacity survives clear(), so a sink drained between
+// batches never allocates on the event path.
+class DeltaSink {
+public:
+    explicit DeltaSink(std::size_t capacity = 4096) { deltas_.reserve(capacity); }
+
+    void clear() { deltas_.clear(); }
+
+    const std::vector<LevelDelta>& deltas() const { return deltas_; }
+
+    // Writer side, used by OrderBook
+    void record(double t, Side side, Tick price, int qty)
+    {
+        deltas_.push_back({t, price, qty, side});
+    }
+
+private:
+    std::vector<LevelDelta> deltas_;
+};
@@ -1,16 +1,27 @@
 #pragma once
 
+#include "book_journal.h"
 #include "event.h"
-#include <map>
+#include "event_buffer.h"
+#include "execution.h"
+#include "level_delta.h"
+#include "price_ladder.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <optional>
 #include <cstddef>
+#include <cstdlib>
 #include <limits>  // for NaN
+#include <vector>
 
+// Best prices are in ticks; convert with OrderBook::to_price() for output
 struct TopOfBook {
-    std::optional<double> best_bid_price;
-    std::optional<int>    best_bid_qty;
-    std::optional<double> best_ask_price;
-    std::optional<int>    best_ask_qty;
+    std::optional<Tick> best_bid_price;
+    std::optional<int>  best_bid_qty;
+    std::optional<Tick> best_ask_price;
+    std::optional<int>  best_ask_qty;
 };
 
 struct Metrics {
@@ -19,31 +30,726 @@ struct Metrics {
     std::optional<double> imbalance_top1;
 };
 
-class OrderBook {
+// Depth-aware analytics, read in O(1) from sums the ladders maintain.
+// Depth windows count the N ticks from each best level (best inclusive).
+struct ExtendedMetrics {
+    std::optional<double> microprice;         // (ask*qb + bid*qa) / (qb + qa)
+    std::optional<double> imbalance_depth5;
+    std::optional<double> imbalance_depth10;
+
+    std::int64_t bid_depth5 = 0;
+    std::int64_t ask_depth5 = 0;
+    std::int64_t bid_depth10 = 0;
+    std::int64_t ask_depth10 = 0;
+    std::int64_t bid_depth_total = 0;         // cumulative depth over all levels
+    std::int64_t ask_depth_total = 0;
+};
+
+// Fixed-size L2 snapshot of the N best levels per side (prices in ticks).
+// Entries past bid_count/ask_count are left untouched.
+template <std::size_t N>
+struct DepthSnapshot {
+    std::array<Tick, N> bid_price;
+    std::array<int, N>  bid_qty;
+    std::array<Tick, N> ask_price;
+    std::array<int, N>  ask_qty;
+    std::size_t bid_count = 0;
+    std::size_t ask_count = 0;
+};
+
+// Trading phase of a book. In Auction, Adds rest without executing (the book
+// may cross) and Market orders are collected as unpriced interest until
+// uncross().
+enum class BookPhase : std::uint8_t {
+    Continuous,
+    Auction
+};
+
+// Outcome of a call-auction uncross
+struct AuctionResult {
+    Tick price = 0;                  // uncrossing price (0 if nothing traded)
+    std::int64_t volume = 0;         // quantity executed on each side
+    std::int64_t buy_surplus = 0;    // demand left unexecuted at `price`
+    std::int64_t sell_surplus = 0;   // supply left unexecuted at `price`
+};
+
+// mid/spread/top-1 imbalance from a top-of-book snapshot (prices in ticks)
+inline Metrics book_metrics(const TopOfBook& tob, double tick_size)
+{
+    Metrics m{};
+
+    if (tob.best_bid_price && tob.best_ask_price) {
+        const Tick bid = *tob.best_bid_price;
+        const Tick ask = *tob.best_ask_price;
+
+        m.mid    = 0.5 * to_price(bid + ask, tick_size);
+        m.spread = to_price(ask - bid, tick_size);
+
+        const double qb = tob.best_bid_qty ? static_cast<double>(*tob.best_bid_qty) : 0.0;
+        const double qa = tob.best_ask_qty ? static_cast<double>(*tob.best_ask_qty) : 0.0;
+
+        const double denom = qb + qa;
+        if (denom > 0.0) {
+            m.imbalance_top1 = (qb - qa) / denom;
+        }
+    }
+
+    return m;
+}
+
+template <typename Ladder>
+ExtendedMetrics book_extended_metrics(const Ladder& bids, const Ladder& asks, double tick_size)
+{
+    ExtendedMetrics m{};
+
+    m.bid_depth5      = bids.depth5();
+    m.ask_depth5      = asks.depth5();
+    m.bid_depth10     = bids.depth10();
+    m.ask_depth10     = asks.depth10();
+    m.bid_depth_total = bids.total_qty();
+    m.ask_depth_total = asks.total_qty();
+
+    if (bids.empty() || asks.empty()) return m;
+
+    const double qb = static_cast<double>(bids.best_qty());
+    const double qa = static_cast<double>(asks.best_qty());
+    const double bid = to_price(bids.best(), tick_size);
+    const double ask = to_price(asks.best(), tick_size);
+    m.microprice = (ask * qb + bid * qa) / (qb + qa);
+
+    const double d5 = static_cast<double>(m.bid_depth5 + m.ask_depth5);
+    const double d10 = static_cast<double>(m.bid_depth10 + m.ask_depth10);
+    m.imbalance_depth5 = static_cast<double>(m.bid_depth5 - m.ask_depth5) / d5;
+    m.imbalance_depth10 = static_cast<double>(m.bid_depth10 - m.ask_depth10) / d10;
+
+    return m;
+}
+
+// Caller-owned per-event output columns for OrderBook::apply_batch().
+// Each non-null pointer must have room for n entries; null columns are skipped.
+// Empty sides are written as price 0 / qty 0, undefined metrics as NaN.
+struct BookSeries {
+    Tick*   best_bid       = nullptr;
+    int*    best_bid_qty   = nullptr;
+    Tick*   best_ask       = nullptr;
+    int*    best_ask_qty   = nullptr;
+    double* mid            = nullptr;
+    double* spread         = nullptr;
+    double* imbalance_top1 = nullptr;
+    std::uint8_t* accepted = nullptr;   // apply() result per event
+};
+
+// Aggregated (L2) book over two tick-indexed ladders.
+//
+// Window fixes the ladder window in ticks at compile time (a power of two),
+// 0 = growable. Levels that land beyond a fixed window go to the ladder's
+// sparse tail.
+//
+// OrderBook is the runtime-configured variant used everywhere else.
+template <std::size_t Window = 0>
+class BasicOrderBook {
 public:
-    // tick_size is required so we can round prices consistently
-    explicit OrderBook(double tick_size = 0.1);
+    using Ladder = BasicPriceLadder<Window>;
+
+    // tick_size maps integer tick prices back to prices at output time
+    explicit BasicOrderBook(double tick_size = 0.1);
 
     bool apply(const Event& e);
 
+    // Applies events[0..n) in order and writes the post-event top of book and
+    // metrics into `out` in the same pass. The best bid/ask and their
+    // quantities are carried in locals across the batch; after each event only
+    // a side it can have moved is re-read from its ladder. Returns the number
+    // of accepted events.
+    std::size_t apply_batch(const Event* events, std::size_t n, const BookSeries& out);
+
+    // Same, decoding packed events straight from the buffer's columns
+    std::size_t apply_batch(const EventBuffer& events, const BookSeries& out);
+
     TopOfBook top() const;
     Metrics metrics() const;
+    ExtendedMetrics extended_metrics() const { return book_extended_metrics(bids_, asks_, tick_size()); }
+
+    // Copies up to n best levels of one side into caller buffers (no allocation).
+    // Returns the number of levels written.
+    std::size_t depth(Side side, Tick* prices, int* qtys, std::size_t n) const
+    {
+        return (side == Side::Bid ? bids_ : asks_).copy_levels(prices, qtys, n);
+    }
+
+    template <std::size_t N>
+    void snapshot(DepthSnapshot<N>& out) const
+    {
+        out.bid_count = bids_.copy_levels(out.bid_price.data(), out.bid_qty.data(), N);
+        out.ask_count = asks_.copy_levels(out.ask_price.data(), out.ask_qty.data(), N);
+    }
+
+    std::size_t bid_levels() const { return bids_.levels(); }
+    std::size_t ask_levels() const { return asks_.levels(); }
+
+    // Keeps a Fenwick index per side so the depth queries below are
+    // O(log levels) instead of a walk from the touch. Off by default because
+    // it adds a log-time update to every level change.
+    void enable_depth_index(bool on = true)
+    {
+        bids_.enable_index(on);
+        asks_.enable_index(on);
+    }
+
+    // Bounds each side's dense window to about `ticks` ticks (0 = unbounded).
+    // Levels further from the touch are kept in a sorted sparse tail, so a
+    // stray far order no longer doubles the array.
+    void set_max_window(std::size_t ticks)
+    {
+        bids_.set_max_window(ticks);
+        asks_.set_max_window(ticks);
+    }
+
+    // Cost of an aggressive order of `qty` without applying it: the opposite
+    // side is swept from the touch (asks for a Bid aggressor). `filled` is
+    // capped at the resting quantity.
+    typename Ladder::Sweep sweep_cost(Side aggressor, std::int64_t qty) const
+    {
+        return (aggressor == Side::Bid ? asks_ : bids_).sweep(qty);
+    }
 
-    std::size_t bid_levels() const { return bids_.size(); }
-    std::size_t ask_levels() const { return asks_.size(); }
+    // Worst price an aggressive order of `qty` would trade at, or nullopt if
+    // the opposite side cannot fill it completely
+    std::optional<Tick> price_after(Side aggressor, std::int64_t qty) const
+    {
+        const Ladder& side = (aggressor == Side::Bid) ? asks_ : bids_;
+        if (qty <= 0 || qty > side.total_qty()) return std::nullopt;
+        return side.sweep(qty).last_price;
+    }
+
+    // Resting quantity within k ticks of one side's best level (best inclusive)
+    std::int64_t depth_within(Side side, Tick k) const
+    {
+        return (side == Side::Bid ? bids_ : asks_).depth_within(k);
+    }
 
     double tick_size() const { return tick_size_; }
+    double to_price(Tick tick) const { return ::to_price(tick, tick_size()); }
+
+    // Levels plus the trading phase and any auction interest collected so
+    // far; attached sinks and the journal are not part of a checkpoint.
+    // Restoring copies into this book's existing buffers, so forking a
+    // warmed-up book into many paths does not allocate once the buffers have
+    // grown.
+    struct Checkpoint {
+        Ladder bids{Side::Bid};
+        Ladder asks{Side::Ask};
+        BookPhase phase = BookPhase::Continuous;
+        std::int64_t auction_buy = 0;
+        std::int64_t auction_sell = 0;
+    };
+
+    Checkpoint checkpoint() const
+    {
+        return Checkpoint{bids_, asks_, phase_, auction_buy_, auction_sell_};
+    }
+    void checkpoint(Checkpoint& out) const
+    {
+        out.bids = bids_;
+        out.asks = asks_;
+        out.phase = phase_;
+        out.auction_buy = auction_buy_;
+        out.auction_sell = auction_sell_;
+    }
+    void restore(const Checkpoint& cp)
+    {
+        bids_ = cp.bids;
+        asks_ = cp.asks;
+        phase_ = cp.phase;
+        auction_buy_ = cp.auction_buy;
+        auction_sell_ = cp.auction_sell;
+    }
+
+    // Empties the book and returns it to Continuous with no auction interest.
+    // Unlike restore(Checkpoint{}), it keeps the set_max_window() bound and
+    // the depth index setting. Attached sinks are not told; not journaled.
+    void clear()
+    {
+        bids_.clear();
+        asks_.clear();
+        phase_ = BookPhase::Continuous;
+        auction_buy_ = auction_sell_ = 0;
+    }
+
+    // Attach (or detach with nullptr) a sink that receives one Execution per
+    // aggressive order plus one Fill per level swept. Not owned.
+    void set_fill_sink(FillSink* sink) { fill_sink_ = sink; }
+
+    // Attach (or detach with nullptr) a sink that receives the new quantity of
+    // every level an event changes, in the order the changes happen. Not owned.
+    // restore() does not emit deltas.
+    void set_delta_sink(DeltaSink* sink) { delta_sink_ = sink; }
+
+    // Sets one level to the quantity a delta carries; replaying a delta
+    // stream from an empty book rebuilds the full depth it was taken from.
+    void apply_delta(const LevelDelta& d);
+
+    // Attach (or detach with nullptr) a journal. Attaching snapshots the
+    // current levels and phase; from then on every accepted apply(),
+    // begin_auction() and uncross() is recorded. apply_delta(), clear() and
+    // restore() are not journaled. Not owned.
+    void set_journal(BookJournal* journal)
+    {
+        journal_ = journal;
+        if (journal_) journal_->start(*this);
+    }
+
+    // Switching to Auction starts a collection phase; uncross() ends it.
+    void begin_auction()
+    {
+        phase_ = BookPhase::Auction;
+        if (journal_) journal_->record_begin_auction();
+    }
+    BookPhase phase() const { return phase_; }
+
+    // Market interest collected on one side (Bid = buys) in the current auction
+    std::int64_t auction_interest(Side side) const
+    {
+        return side == Side::Bid ? auction_buy_ : auction_sell_;
+    }
+
+    // Executes the collected auction at the single price that maximizes
+    // traded volume (ties: smallest surplus, then closest to `reference`;
+    // 0 = midpoint of the collected best bid and ask). Market interest trades
+    // first on its side; any of it left over is dropped. The book returns to
+    // Continuous and is uncrossed. Level changes go to the DeltaSink; no
+    // Executions are reported since auction trades have no aggressor.
+    AuctionResult uncross(double t, Tick reference = 0);
 
 private:
     double tick_size_;
-    std::map<double, int> bids_;
-    std::map<double, int> asks_;
+    Ladder bids_;
+    Ladder asks_;
+    FillSink* fill_sink_ = nullptr;
+    DeltaSink* delta_sink_ = nullptr;
+    BookJournal* journal_ = nullptr;
+
+    BookPhase phase_ = BookPhase::Continuous;
+    std::int64_t auction_buy_ = 0;    // Market interest collected in Auction
+    std::int64_t auction_sell_ = 0;
+
+    // Level copies reused by uncross() (bids best first, asks best first)
+    std::vector<Tick> auction_bid_px_, auction_ask_px_;
+    std::vector<int> auction_bid_qty_, auction_ask_qty_;
+
+    bool apply_event(const Event& e);
+
+    // Best levels carried through apply_batch() (price 0 / qty 0 when empty)
+    struct Touch {
+        Tick bid = 0;
+        Tick ask = 0;
+        int bid_qty = 0;
+        int ask_qty = 0;
+    };
+
+    void read_touch(Side side, Touch& touch) const;
+
+    // Re-reads the sides an accepted event can have moved. `touch` must still
+    // hold the levels from before the event.
+    void update_touch(const Event& e, Touch& touch) const;
+
+    template <typename Events>
+    std::size_t apply_series(const Events& events, std::size_t n, const BookSeries& out);
+
+    // Writes row i of a BookSeries from the carried best levels
+    void record_series(std::size_t i, bool accepted, const Touch& touch,
+                       const BookSeries& out) const;
+
+    void add_level(Ladder& side, Tick price, int qty, double t);
+    void remove_level_qty(Ladder& side, Tick price, int qty, double t);
+
+    // Removes qty from the best levels of `side` during an uncross
+    void execute_auction_side(Ladder& side, std::int64_t qty, double t);
+
+    // Sweeps the best levels of `side` (asks for a buy, bids for a sell)
+    void consume_best(Ladder& side, int qty, double t);
+    // Sweep path used when a FillSink and/or DeltaSink is attached
+    void consume_best_reported(Ladder& side, int qty, double t);
+
+    void emit_delta(const Ladder& side, Tick price, double t)
+    {
+        if (delta_sink_) delta_sink_->record(t, side.side(), price, side.qty_at(price));
+    }
+};
+
+/*
+Core principles:
+- All incoming prices (Add/Cancel) are integer ticks, so levels compare exactly
+- Each side is a tick-indexed PriceLadder, so best-level lookups are O(1)
+- Marketable limit orders immediately execute against the opposite side
+- Pure market orders also consume opposite side
+- Price only changes when a best level is fully depleted
+- Aggressive orders are reported to the FillSink only when one is attached
+- Every level change is reported to the DeltaSink only when one is attached
+- Accepted events and phase changes are journaled only when a BookJournal is attached
+- In the Auction phase nothing executes until uncross()
+*/
+
+template <std::size_t Window>
+BasicOrderBook<Window>::BasicOrderBook(double tick_size)
+    : tick_size_(tick_size),
+      bids_(Side::Bid),
+      asks_(Side::Ask)
+{
+    if (!(tick_size_ > 0.0) || !std::isfinite(tick_size_)) {
+        tick_size_ = 0.1;  // sane fallback
+    }
+}
+
+template <std::size_t Window>
+void BasicOrderBook<Window>::add_level(Ladder& side, Tick price, int qty, double t)
+{
+    side.add(price, qty);
+    emit_delta(side, price, t);
+}
+
+template <std::size_t Window>
+void BasicOrderBook<Window>::remove_level_qty(Ladder& side, Tick price, int qty,
+                                                             double t)
+{
+    if (side.reduce(price, qty) > 0) emit_delta(side, price, t);
+}
+
+template <std::size_t Window>
+void BasicOrderBook<Window>::consume_best(Ladder& side, int qty, double t)
+{
+    if (fill_sink_ || delta_sink_) {
+        consume_best_reported(side, qty, t);
+        return;
+    }
+    while (qty > 0 && !side.empty()) {
+        // reduce() removes min(qty, level) and advances best when depleted
+        qty -= side.reduce(side.best(), qty);
+    }
+}
+
+template <std::size_t Window>
+void BasicOrderBook<Window>::consume_best_reported(Ladder& side, int qty, double t)
+{
+    // The aggressor is on the opposite side of the ladder being swept
+    const Side aggressor = (side.side() == Side::Ask) ? Side::Bid : Side::Ask;
+    Execution* x = fill_sink_
+        ? &fill_sink_->begin(t, aggressor, qty, side.empty() ? 0 : side.best())
+        : nullptr;
+
+    while (qty > 0 && !side.empty()) {
+        const Tick px = side.best();
+        const int taken = side.reduce(px, qty);
+        qty -= taken;
+        if (x) fill_sink_->record(*x, px, taken);
+        emit_delta(side, px, t);
+    }
+}
+
+template <std::size_t Window>
+void BasicOrderBook<Window>::apply_delta(const LevelDelta& d)
+{
+    if (d.price <= 0 || d.qty < 0) return;
+
+    Ladder& side = (d.side == Side::Bid) ? bids_ : asks_;
+    const int current = side.qty_at(d.price);
+
+    if (d.qty > current) {
+        side.add(d.price, d.qty - current);
+    } else if (d.qty < current) {
+        side.reduce(d.price, current - d.qty);
+    }
+}
+
+template <std::size_t Window>
+bool BasicOrderBook<Window>::apply(const Event& e)
+{
+    const bool ok = apply_event(e);
+    if (ok && journal_) journal_->record(e, *this);
+    return ok;
+}
+
+template <std::size_t Window>
+bool BasicOrderBook<Window>::apply_event(const Event& e)
+{
+    if (!std::isfinite(e.t) || e.quantity <= 0) return false;
+
+    switch (e.type) {
+        case EventType::Add: {
+            if (e.price <= 0) return false;
+
+            const Tick px = e.price;
+
+            if (e.side == Side::Bid) {
+                // Marketable limit buy: price >= best ask → execute immediately
+                // (during an auction it rests and the book may cross)
+                if (phase_ == BookPhase::Continuous && !asks_.empty() && px >= asks_.best()) {
+                    consume_best(asks_, e.quantity, e.t);
+                    return true;
+                }
+                // Passive: add to bids
+                add_level(bids_, px, e.quantity, e.t);
+                return true;
+            } else {  // Ask side
+                // Marketable limit sell: price <= best bid → execute immediately
+                if (phase_ == BookPhase::Continuous && !bids_.empty() && px <= bids_.best()) {
+                    consume_best(bids_, e.quantity, e.t);
+                    return true;
+                }
+                // Passive: add to asks
+                add_level(asks_, px, e.quantity, e.t);
+                return true;
+            }
+        }
+
+        case EventType::Cancel: {
+            if (e.price <= 0) return false;
+            const Tick px = e.price;
+
+            if (e.side == Side::Bid) {
+                remove_level_qty(bids_, px, e.quantity, e.t);
+            } else {
+                remove_level_qty(asks_, px, e.quantity, e.t);
+            }
+            return true;
+        }
+
+        case EventType::Market: {
+            if (phase_ == BookPhase::Auction) {
+                (e.side == Side::Bid ? auction_buy_ : auction_sell_) += e.quantity;
+                return true;
+            }
+            if (e.side == Side::Bid) {           // Market Buy → consume asks
+                consume_best(asks_, e.quantity, e.t);
+            } else {                             // Market Sell → consume bids
+                consume_best(bids_, e.quantity, e.t);
+            }
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+template <std::size_t Window>
+std::size_t BasicOrderBook<Window>::apply_batch(const Event* events, std::size_t n,
+                                                                const BookSeries& out)
+{
+    return apply_series(events, n, out);
+}
+
+template <std::size_t Window>
+std::size_t BasicOrderBook<Window>::apply_batch(const EventBuffer& events,
+                                                                const BookSeries& out)
+{
+    return apply_series(events, events.size(), out);
+}
+
+template <std::size_t Window>
+template <typename Events>
+std::size_t BasicOrderBook<Window>::apply_series(const Events& events,
+                                                                 std::size_t n,
+                                                                 const BookSeries& out)
+{
+    Touch touch;
+    read_touch(Side::Bid, touch);
+    read_touch(Side::Ask, touch);
+
+    std::size_t accepted = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const Event e = events[i];
+        const bool ok = apply(e);
+        if (ok) {
+            ++accepted;
+            update_touch(e, touch);
+        }
+        record_series(i, ok, touch, out);
+    }
+    return accepted;
+}
+
+template <std::size_t Window>
+void BasicOrderBook<Window>::read_touch(Side side, Touch& touch) const
+{
+    if (side == Side::Bid) {
+        touch.bid = bids_.empty() ? 0 : bids_.best();
+        touch.bid_qty = bids_.empty() ? 0 : bids_.best_qty();
+    } else {
+        touch.ask = asks_.empty() ? 0 : asks_.best();
+        touch.ask_qty = asks_.empty() ? 0 : asks_.best_qty();
+    }
+}
+
+template <std::size_t Window>
+void BasicOrderBook<Window>::update_touch(const Event& e, Touch& touch) const
+{
+    const Side other = (e.side == Side::Bid) ? Side::Ask : Side::Bid;
+    const bool bid = (e.side == Side::Bid);
+    const Tick own = bid ? touch.bid : touch.ask;          // 0 = side was empty
+    const Tick opposite = bid ? touch.ask : touch.bid;
+    const bool continuous = (phase_ == BookPhase::Continuous);
+
+    switch (e.type) {
+        case EventType::Add: {
+            // Same marketability test as apply_event(), on the pre-event touch
+            const bool marketable =
+                continuous && opposite != 0 && (bid ? e.price >= opposite : e.price <= opposite);
+            if (marketable) {
+                read_touch(other, touch);
+            } else if (own == 0 || (bid ? e.price >= own : e.price <= own)) {
+                read_touch(e.side, touch);
+            }
+            break;
+        }
+        case EventType::Cancel:
+            if (e.price == own) read_touch(e.side, touch);
+            break;
+        case EventType::Market:
+            if (continuous) read_touch(other, touch);
+            break;
+        default:
+            break;
+    }
+}
+
+template <std::size_t Window>
+void BasicOrderBook<Window>::record_series(std::size_t i, bool ok,
+                                                          const Touch& touch,
+                                                          const BookSeries& out) const
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    const Tick bid  = touch.bid;
+    const Tick ask  = touch.ask;
+    const int  qb   = touch.bid_qty;
+    const int  qa   = touch.ask_qty;
+    const bool both = bid != 0 && ask != 0;
+
+    if (out.accepted)     out.accepted[i]     = static_cast<std::uint8_t>(ok);
+    if (out.best_bid)     out.best_bid[i]     = bid;
+    if (out.best_bid_qty) out.best_bid_qty[i] = qb;
+    if (out.best_ask)     out.best_ask[i]     = ask;
+    if (out.best_ask_qty) out.best_ask_qty[i] = qa;
+    if (out.mid)    out.mid[i]    = both ? 0.5 * to_price(bid + ask) : nan;
+    if (out.spread) out.spread[i] = both ? to_price(ask - bid) : nan;
+    if (out.imbalance_top1) {
+        const double denom = static_cast<double>(qb) + static_cast<double>(qa);
+        out.imbalance_top1[i] = (both && denom > 0.0) ? (qb - qa) / denom : nan;
+    }
+}
+
+template <std::size_t Window>
+AuctionResult BasicOrderBook<Window>::uncross(double t, Tick reference)
+{
+    if (journal_) journal_->record_uncross(t, reference);
+
+    AuctionResult r;
+    phase_ = BookPhase::Continuous;
+
+    const std::int64_t mkt_buy = auction_buy_;
+    const std::int64_t mkt_sell = auction_sell_;
+    auction_buy_ = auction_sell_ = 0;
+
+    const std::size_t nb = bids_.levels();
+    const std::size_t na = asks_.levels();
+    if (nb == 0 && na == 0) return r;
+
+    auction_bid_px_.resize(nb);
+    auction_bid_qty_.resize(nb);
+    auction_ask_px_.resize(na);
+    auction_ask_qty_.resize(na);
+    bids_.copy_levels(auction_bid_px_.data(), auction_bid_qty_.data(), nb);
+    asks_.copy_levels(auction_ask_px_.data(), auction_ask_qty_.data(), na);
+
+    if (reference <= 0 && nb > 0 && na > 0) reference = (bids_.best() + asks_.best()) / 2;
+
+    // One ascending pass over every level price. Demand at p is market buys
+    // plus bids priced >= p (a running suffix sum), supply is market sells
+    // plus asks priced <= p (a running prefix sum).
+    std::int64_t demand = mkt_buy + bids_.total_qty();
+    std::int64_t supply = mkt_sell;
+    std::size_t j = nb;   // bids ascending: auction_bid_px_[j - 1]
+    std::size_t k = 0;    // asks ascending: auction_ask_px_[k]
+
+    std::int64_t best_surplus = 0;
+    while (j > 0 || k < na) {
+        Tick p;
+        if (j == 0) p = auction_ask_px_[k];
+        else if (k == na) p = auction_bid_px_[j - 1];
+        else p = std::min(auction_bid_px_[j - 1], auction_ask_px_[k]);
+
+        while (k < na && auction_ask_px_[k] == p) supply += auction_ask_qty_[k++];
+
+        const std::int64_t volume = std::min(demand, supply);
+        const std::int64_t surplus = demand > supply ? demand - supply : supply - demand;
+        const bool better =
+            volume > r.volume ||
+            (volume == r.volume && volume > 0 &&
+             (surplus < best_surplus ||
+              (surplus == best_surplus && reference > 0 &&
+               std::abs(p - reference) < std::abs(r.price - reference))));
+        if (better) {
+            r.price = p;
+            r.volume = volume;
+            r.buy_surplus = demand - volume;
+            r.sell_surplus = supply - volume;
+            best_surplus = surplus;
+        }
+
+        while (j > 0 && auction_bid_px_[j - 1] == p) demand -= auction_bid_qty_[--j];
+    }
+
+    if (r.volume == 0) {
+        r = AuctionResult{};
+        return r;
+    }
+
+    // Market interest has priority; limit orders fill best price first
+    execute_auction_side(bids_, r.volume - std::min(mkt_buy, r.volume), t);
+    execute_auction_side(asks_, r.volume - std::min(mkt_sell, r.volume), t);
+    return r;
+}
+
+template <std::size_t Window>
+void BasicOrderBook<Window>::execute_auction_side(Ladder& side, std::int64_t qty,
+                                                                 double t)
+{
+    while (qty > 0 && !side.empty()) {
+        const Tick px = side.best();
+        const int take = static_cast<int>(std::min<std::int64_t>(qty, side.best_qty()));
+        side.reduce(px, take);
+        qty -= take;
+        emit_delta(side, px, t);
+    }
+}
+
+template <std::size_t Window>
+TopOfBook BasicOrderBook<Window>::top() const
+{
+    TopOfBook tob{};
+
+    if (!bids_.empty()) {
+        tob.best_bid_price = bids_.best();
+        tob.best_bid_qty   = bids_.best_qty();
+    }
+
+    if (!asks_.empty()) {
+        tob.best_ask_price = asks_.best();
+        tob.best_ask_qty   = asks_.best_qty();
+    }
+
+    return tob;
+}
 
-    double round_to_tick(double price) const;
+template <std::size_t Window>
+Metrics BasicOrderBook<Window>::metrics() const
+{
+    return book_metrics(top(), tick_size());
+}
 
-    void add_level(std::map<double, int>& side_map, double price, int qty);
-    void remove_level_qty(std::map<double, int>& side_map, double price, int qty);
+// Runtime-configured book: tick size chosen at construction, growable window
+using OrderBook = BasicOrderBook<>;
 
-    void consume_best_ask(std::map<double, int>& asks, int qty);
-    void consume_best_bid(std::map<double, int>& bids, int qty);
-};
\ No newline at end of file
+// Compiled once, in order_book.cpp
+extern template class BasicOrderBook<>;
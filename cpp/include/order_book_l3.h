@@ -0,0 +1,116 @@
+#pragma once
+
+#include "event.h"
+#include "order_book.h"
+#include "price_ladder.h"
+#include "flat_hash_map.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+using OrderId = std::uint64_t;
+
+// One execution against a resting order
+struct OrderFill {
+    OrderId id = 0;          // resting (passive) order that traded
+    Tick price = 0;          // level it traded at, in ticks
+    int qty = 0;             // quantity executed against it
+    bool complete = false;   // true if the resting order was fully filled
+};
+
+// Order-by-order (L3) book.
+//
+// Each price level holds a FIFO queue of orders. Orders live in a pooled
+// array and are linked through indices (intrusive list), so adding,
+// cancelling and filling never allocate once the pool is warm. An order-ID
+// hash index gives O(1) cancel/modify.
+//
+// Aggregated level quantities are kept in the same PriceLadder used by
+// OrderBook, so top()/metrics() and apply() match the aggregated book exactly;
+// the queues only decide *which* orders trade or are cancelled.
+class OrderBookL3 {
+public:
+    explicit OrderBookL3(double tick_size = 0.1, std::size_t expected_orders = 4096);
+
+    // Same semantics as OrderBook::apply(). Adds rest as new orders (IDs are
+    // assigned sequentially), aggregate Cancels remove quantity from the back
+    // of the level's queue (most recent orders first), and Market/marketable
+    // orders fill resting orders front to back.
+    bool apply(const Event& e);
+
+    // Order-level interface. add() returns the new order's ID, or 0 if the
+    // order was rejected or executed immediately (marketable).
+    OrderId add(Side side, Tick price, int qty);
+    bool cancel(OrderId id);
+
+    // Reducing quantity keeps queue priority; increasing it sends the order
+    // to the back of its level. new_qty <= 0 cancels.
+    bool modify(OrderId id, int new_qty);
+
+    // Quantity resting ahead of the order at its level
+    std::optional<int> queue_ahead(OrderId id) const;
+
+    // Per-order fills produced by the most recent apply()/add() call
+    const std::vector<OrderFill>& fills() const { return fills_; }
+
+    TopOfBook top() const;
+    Metrics metrics() const;
+    ExtendedMetrics extended_metrics() const { return book_extended_metrics(bids_, asks_, tick_size_); }
+
+    std::size_t bid_levels() const { return bids_.levels(); }
+    std::size_t ask_levels() const { return asks_.levels(); }
+    std::size_t order_count() const { return index_.size(); }
+
+    double tick_size() const { return tick_size_; }
+    double to_price(Tick tick) const { return ::to_price(tick, tick_size_); }
+
+private:
+    static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+
+    struct Order {
+        OrderId id = 0;
+        Tick price = 0;
+        int qty = 0;
+        Side side{};
+        std::uint32_t prev = npos;
+        std::uint32_t next = npos;
+    };
+
+    struct LevelQueue {
+        std::uint32_t head = npos;
+        std::uint32_t tail = npos;
+    };
+
+    double tick_size_;
+    PriceLadder bids_;
+    PriceLadder asks_;
+
+    std::vector<Order> pool_;
+    std::uint32_t free_ = npos;   // free list threaded through Order::next
+
+    FlatHashMap<OrderId, std::uint32_t> index_;     // order ID -> pool slot
+    FlatHashMap<Tick, LevelQueue> bid_queues_;
+    FlatHashMap<Tick, LevelQueue> ask_queues_;
+
+    OrderId next_id_ = 1;
+    std::vector<OrderFill> fills_;
+
+    PriceLadder& ladder(Side side) { return side == Side::Bid ? bids_ : asks_; }
+    FlatHashMap<Tick, LevelQueue>& queues(Side side)
+    {
+        return side == Side::Bid ? bid_queues_ : ask_queues_;
+    }
+
+    std::uint32_t allocate();
+    void release(std::uint32_t slot);
+
+    void push_back(LevelQueue& q, std::uint32_t slot);
+    void unlink(LevelQueue& q, std::uint32_t slot);
+    void remove_order(LevelQueue& q, std::uint32_t slot);
+
+    OrderId add_resting(Side side, Tick price, int qty);
+    void cancel_level_qty(Side side, Tick price, int qty);
+    void consume_best(Side book_side, int qty);
+};
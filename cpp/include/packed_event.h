@@ -0,0 +1,58 @@
+#pragma once
+
+#include "event.h"
+
+#include <cmath>
+#include <cstdint>
+
+// 16-byte storage/wire form of an Event.
+//
+// Time is fixed point (integer nanoseconds) in the upper 56 bits of `stamp`,
+// with type and side in the low byte, so an event packs into two 32-bit
+// fields plus one 64-bit word with no padding. The instrument is not carried.
+//
+// Preconditions for pack(): 0 <= t < 2^56 ns (about 833 days), and price and
+// quantity fit in 32 bits.
+struct PackedEvent {
+    std::uint64_t stamp = 0;   // (time_ns << 8) | (side << 2) | type
+    std::int32_t price = 0;    // ticks
+    std::int32_t qty = 0;
+
+    static constexpr double kTimeScale = 1e9;   // stamp time units per second
+
+    static std::uint64_t encode_time(double t)
+    {
+        return static_cast<std::uint64_t>(std::llround(t * kTimeScale)) << 8;
+    }
+    static std::uint8_t encode_code(EventType type, Side side)
+    {
+        return static_cast<std::uint8_t>(static_cast<unsigned>(type) |
+                                         (static_cast<unsigned>(side) << 2));
+    }
+
+    double t() const { return static_cast<double>(stamp >> 8) / kTimeScale; }
+    EventType type() const { return static_cast<EventType>(stamp & 0x3u); }
+    Side side() const { return static_cast<Side>((stamp >> 2) & 0x1u); }
+};
+
+static_assert(sizeof(PackedEvent) == 16, "PackedEvent must stay 16 bytes");
+
+inline PackedEvent pack(const Event& e)
+{
+    PackedEvent p;
+    p.stamp = PackedEvent::encode_time(e.t) | PackedEvent::encode_code(e.type, e.side);
+    p.price = static_cast<std::int32_t>(e.price);
+    p.qty = e.quantity;
+    return p;
+}
+
+inline Event unpack(const PackedEvent& p)
+{
+    Event e;
+    e.t = p.t();
+    e.price = p.price;
+    e.quantity = p.qty;
+    e.type = p.type();
+    e.side = p.side();
+    return e;
+}
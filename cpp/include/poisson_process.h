@@ -1,11 +1,16 @@
 #pragma once
 
 #include "process.h"
-#include <random>
+#include "random_buffer.h"
 
-class PoissonProcess : public EventProcess {
+// Homogeneous Poisson event stream; Rng is the random number policy (see rng.h
+// and random_buffer.h)
+template <typename Rng = BufferedRandom>
+class BasicPoissonProcess : public EventProcess {
 public:
-    PoissonProcess(
+    using Generator = Rng;
+
+    BasicPoissonProcess(
         double lambda,
         double price_center,
         double tick_size,
@@ -17,13 +22,62 @@ public:
     Event next(double t) override;
 
 private:
-    std::mt19937 rng_;
-    std::exponential_distribution<double> inter_arrival_;
-    std::uniform_int_distribution<int> qty_dist_;
-    std::bernoulli_distribution side_dist_;
-    std::bernoulli_distribution type_dist_;
+    Rng rng_;
+    double lambda_;
+    int qty_min_;
+    int qty_max_;
+
+    Tick price_center_;   // centre of the placement band, in ticks
+
+};
+
+using PoissonProcess = BasicPoissonProcess<>;
+
+template <typename Rng>
+BasicPoissonProcess<Rng>::BasicPoissonProcess(
+    double lambda,
+    double price_center,
+    double tick_size,
+    int qty_min,
+    int qty_max,
+    unsigned seed
+
+)
+  : rng_(seed),
+    lambda_(lambda),
+    qty_min_(qty_min),
+    qty_max_(qty_max),
+    price_center_(to_ticks(price_center, tick_size))
+{
+}
+
+template <typename Rng>
+Event BasicPoissonProcess<Rng>::next(double t)
+{
+    Event e{};
+
+    // 1) Advance time
+    e.t = t + rng::exponential(rng_, lambda_);
+
+    // 2) Choose side (bid/ask)
+    e.side = rng::bernoulli(rng_, 0.5) ? Side::Bid : Side::Ask;
+
+    // 3) Choose event type (Add / Cancel)
+    e.type = rng::bernoulli(rng_, 0.8) ? EventType::Add : EventType::Cancel;
+
+    // 4) Quantity
+    e.quantity = rng::uniform_int(rng_, qty_min_, qty_max_);
+
+    // 5) Price 
+    int tick_offset = 1 + (rng::uniform_int(rng_, qty_min_, qty_max_) % 5);
 
-    double price_center_;
-    double tick_size_;
+    if (e.side == Side::Bid){
+        e.price = price_center_ - tick_offset;
+    } else {
+        e.price = price_center_ + tick_offset;
+    }
+    return e;
+}
 
-};
\ No newline at end of file
+// Compiled once in poisson_process.cpp
+extern template class BasicPoissonProcess<>;
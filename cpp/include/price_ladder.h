@@ -0,0 +1,691 @@
+#pragma once
+
+#include "event.h"
+#include "depth_index.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ladder_detail {
+
+// x != 0
+inline unsigned lowest_bit(std::uint64_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return static_cast<unsigned>(i);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+inline unsigned highest_bit(std::uint64_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanReverse64(&i, x);
+    return static_cast<unsigned>(i);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(x));
+#endif
+}
+
+// DepthIndex needs a power-of-two window
+inline std::size_t round_up_pow2(std::size_t n)
+{
+    std::size_t p = 16;
+    while (p < n) p *= 2;
+    return p;
+}
+
+}  // namespace ladder_detail
+
+// One side of the book stored as a contiguous array of quantities indexed by
+// tick offset from a moving anchor (base_). Quantity 0 means "no level".
+//
+// - best() / best_qty() are O(1): the best level is tracked incrementally
+// - add() / reduce() touch a single array slot and never allocate
+// - when a price falls outside the window, the live levels are recentered
+//   (and the window doubled only if they no longer fit)
+// - an occupancy bitmap (one bit per slot) lets the next level after a
+//   depletion be found a 64-tick word at a time with ctz/clz
+// - total and near-touch depth sums are updated from the single level that
+//   changed; only a move of the best level rescans (kFarDepth slots)
+// - an optional DepthIndex answers sweep/depth queries in O(log window)
+//
+// The dense window can be bounded (a fixed Window, or set_max_window() on a
+// growable ladder). Levels that do not fit behind the touch are then parked in
+// a sparse tail: a vector sorted best-first, touched only by the rare events
+// that land far from the touch. The best level always lives in the window.
+// When the touch moves past an edge (or the window runs dry), the window is
+// re-anchored on it and levels migrate between the array and the tail.
+//
+// A non-zero Window fixes the window size at compile time (a power of two
+// >= 16): the slots are stored inline, window bounds become constants and the
+// array never grows.
+template <std::size_t Window = 0>
+class BasicPriceLadder {
+    static_assert(Window == 0 || (Window >= 16 && (Window & (Window - 1)) == 0),
+                  "a fixed window must be a power of two >= 16");
+
+public:
+    static constexpr std::size_t kFixedWindow = Window;
+
+    explicit BasicPriceLadder(Side side, std::size_t window = Window ? Window : 512)
+        : side_(side)
+    {
+        if constexpr (Window == 0) {
+            qty_.assign(ladder_detail::round_up_pow2(window), 0);
+        } else {
+            (void)window;
+            qty_.fill(0);
+        }
+        rebuild_occupancy();
+    }
+
+    void add(Tick price, int qty);
+
+    // Removes up to qty from the level; returns the quantity actually removed
+    int reduce(Tick price, int qty);
+
+    int qty_at(Tick price) const
+    {
+        return in_window(price) ? qty_[index(price)] : far_qty_at(price);
+    }
+
+    bool empty() const { return levels_ == 0; }
+    std::size_t levels() const { return levels_; }
+
+    // Preconditions: !empty()
+    Tick best() const { return best_; }
+    int best_qty() const { return qty_[index(best_)]; }
+
+    // Next occupied level strictly worse than `from`; returns false if none
+    bool next_level(Tick from, Tick& out) const;
+
+    // Copies up to n levels, best first, into prices/qtys; returns the count
+    std::size_t copy_levels(Tick* prices, int* qtys, std::size_t n) const;
+
+    // Depth windows are measured in ticks from the best level (inclusive)
+    static constexpr Tick kNearDepth = 5;
+    static constexpr Tick kFarDepth = 10;
+
+    std::int64_t total_qty() const { return total_; }
+    std::int64_t depth5() const { return depth5_; }
+    std::int64_t depth10() const { return depth10_; }
+
+    // Result of sweeping the side from the best level outward
+    struct Sweep {
+        std::int64_t filled = 0;      // quantity available up to the request
+        std::int64_t notional = 0;    // sum(price * qty) over the sweep, in ticks
+        Tick last_price = 0;          // worst level touched (0 if nothing filled)
+    };
+
+    // With the index on, sweep()/depth_within() are O(log window) and every
+    // level change pays one Fenwick update; with it off they walk the array.
+    void enable_index(bool on);
+    bool indexed() const { return indexed_; }
+
+    Sweep sweep(std::int64_t qty) const;
+
+    // Quantity within `ticks` ticks of the best level (best inclusive)
+    std::int64_t depth_within(Tick ticks) const;
+
+    Side side() const { return side_; }
+
+    // Caps the dense window of a growable ladder (rounded up to a power of
+    // two, 0 = unbounded); levels beyond it go to the sparse tail. A fixed
+    // Window is already bounded and ignores this.
+    void set_max_window(std::size_t ticks);
+
+    std::size_t window_size() const { return window(); }
+    std::size_t far_levels() const { return tail_.size(); }
+
+    // Removes every level. The window (its size and set_max_window() bound)
+    // and the depth index setting are kept.
+    void clear();
+
+private:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // Fixed windows keep their slots inline, growable ones on the heap
+    using QtyStorage = std::conditional_t<Window != 0, std::array<int, Window>,
+                                          std::vector<int>>;
+    using BitStorage = std::conditional_t<Window != 0,
+                                          std::array<std::uint64_t, (Window + 63) / 64>,
+                                          std::vector<std::uint64_t>>;
+
+    Side side_;
+    QtyStorage qty_;
+    BitStorage occupied_;     // bit i set <=> qty_[i] != 0
+    Tick base_ = 0;           // tick stored at qty_[0]
+    Tick best_ = 0;
+    std::size_t levels_ = 0;
+
+    std::int64_t total_ = 0;
+    std::int64_t depth5_ = 0;
+    std::int64_t depth10_ = 0;
+
+    bool indexed_ = false;
+    DepthIndex depth_index_;
+
+    // Levels outside the window, sorted best-first (all behind the window)
+    struct FarLevel {
+        Tick price;
+        int qty;
+    };
+    std::vector<FarLevel> tail_;
+    std::int64_t tail_total_ = 0;
+    std::size_t max_window_ = 0;        // 0 = grow without bound
+    std::vector<FarLevel> moved_;       // rebase() scratch
+
+    // Compile-time constant when the window is fixed
+    std::size_t window() const { return Window ? Window : qty_.size(); }
+
+    std::size_t index(Tick price) const { return static_cast<std::size_t>(price - base_); }
+    bool in_window(Tick price) const
+    {
+        return static_cast<std::size_t>(price - base_) < window();
+    }
+    bool better(Tick a, Tick b) const { return side_ == Side::Bid ? a > b : a < b; }
+    Tick distance(Tick price) const { return side_ == Side::Bid ? best_ - price : price - best_; }
+
+    void mark(std::size_t i) { occupied_[i >> 6] |= std::uint64_t{1} << (i & 63); }
+    void unmark(std::size_t i) { occupied_[i >> 6] &= ~(std::uint64_t{1} << (i & 63)); }
+    void rebuild_occupancy();
+
+    // First occupied slot at or above / at or below i (npos if none)
+    std::size_t scan_up(std::size_t i) const;
+    std::size_t scan_down(std::size_t i) const;
+
+    // Next occupied slot after i, walking away from the touch (npos if none)
+    std::size_t step_away(std::size_t i) const
+    {
+        return side_ == Side::Bid ? scan_down(i - 1) : scan_up(i + 1);
+    }
+
+    // DepthIndex positions run from the most aggressive tick of the window
+    std::size_t position(Tick price) const
+    {
+        return side_ == Side::Ask ? index(price) : window() - 1 - index(price);
+    }
+    Tick price_at(std::size_t pos) const
+    {
+        const std::size_t i = side_ == Side::Ask ? pos : window() - 1 - pos;
+        return base_ + static_cast<Tick>(i);
+    }
+    void rebuild_index();
+
+    bool recenter(Tick price);
+    void find_best_from(Tick start);
+
+    // Sparse tail
+    typename std::vector<FarLevel>::iterator far_find(Tick price)
+    {
+        return std::lower_bound(tail_.begin(), tail_.end(), price,
+                                [this](const FarLevel& l, Tick p) { return better(l.price, p); });
+    }
+    int far_qty_at(Tick price) const;
+    void add_far(Tick price, int qty);
+    int reduce_far(Tick price, int qty);
+    bool near_far_edge() const;
+    void rebase(Tick anchor, std::size_t size);
+
+    // `price` is at or behind best_; adjusts the depth windows it falls in
+    void track_depth(Tick price, int delta)
+    {
+        const Tick d = distance(price);
+        if (d < kNearDepth) depth5_ += delta;
+        if (d < kFarDepth) depth10_ += delta;
+    }
+    void refresh_depth();
+};
+
+// Runtime-sized ladder used by OrderBook and OrderBookL3
+using PriceLadder = BasicPriceLadder<>;
+
+template <std::size_t Window>
+void BasicPriceLadder<Window>::add(Tick price, int qty)
+{
+    if (qty <= 0) return;
+    if (!in_window(price) && (!tail_.empty() || !recenter(price))) {
+        // Bounded window: a new touch re-anchors it, anything behind is far
+        if (levels_ == 0 || better(price, best_)) rebase(price, window());
+        if (!in_window(price)) {
+            add_far(price, qty);
+            return;
+        }
+    }
+
+    int& slot = qty_[index(price)];
+    const bool created = (slot == 0);
+    slot += qty;
+    total_ += qty;
+    if (indexed_) depth_index_.update(position(price), qty, price * qty);
+
+    if (created) {
+        mark(index(price));
+        ++levels_;
+        if (levels_ == 1 || better(price, best_)) {
+            best_ = price;
+            refresh_depth();
+            return;
+        }
+    }
+    track_depth(price, qty);
+}
+
+template <std::size_t Window>
+int BasicPriceLadder<Window>::reduce(Tick price, int qty)
+{
+    if (qty <= 0) return 0;
+    if (!in_window(price)) return tail_.empty() ? 0 : reduce_far(price, qty);
+
+    int& slot = qty_[index(price)];
+    if (slot == 0) return 0;
+
+    const int removed = std::min(static_cast<int>(slot), qty);
+    slot -= removed;
+    total_ -= removed;
+    if (indexed_) depth_index_.update(position(price), -removed, -price * removed);
+
+    if (slot == 0) {
+        unmark(index(price));
+        --levels_;
+        if (levels_ == 0) {
+            depth5_ = depth10_ = 0;
+            return removed;
+        }
+        if (price == best_) {
+            if (levels_ == tail_.size()) {
+                // The window ran dry: pull the tail's best level in as the touch
+                const Tick next = tail_.front().price;
+                rebase(next, window());
+                best_ = next;
+            } else {
+                find_best_from(price);
+                if (!tail_.empty() && near_far_edge()) rebase(best_, window());
+            }
+            refresh_depth();
+            return removed;
+        }
+    }
+    track_depth(price, -removed);
+    return removed;
+}
+
+template <std::size_t Window>
+bool BasicPriceLadder<Window>::next_level(Tick from, Tick& out) const
+{
+    const Tick lo = base_;
+    const Tick hi = base_ + static_cast<Tick>(window()) - 1;
+
+    std::size_t i = npos;
+    if (side_ == Side::Bid) {
+        if (from - 1 >= lo) i = scan_down(index(std::min(from - 1, hi)));
+    } else {
+        if (from + 1 <= hi) i = scan_up(index(std::max(from + 1, lo)));
+    }
+    if (i != npos) {
+        out = base_ + static_cast<Tick>(i);
+        return true;
+    }
+
+    const auto it = std::partition_point(tail_.begin(), tail_.end(),
+                                         [&](const FarLevel& l) { return !better(from, l.price); });
+    if (it == tail_.end()) return false;
+    out = it->price;
+    return true;
+}
+
+template <std::size_t Window>
+std::size_t BasicPriceLadder<Window>::copy_levels(Tick* prices, int* qtys,
+                                                       std::size_t n) const
+{
+    if (levels_ == 0 || n == 0) return 0;
+
+    // Hop between occupied slots, walking away from the touch, then the tail
+    const std::size_t want = std::min(n, levels_);
+    std::size_t count = 0;
+
+    for (std::size_t i = index(best_); count < want && i != npos; i = step_away(i)) {
+        prices[count] = base_ + static_cast<Tick>(i);
+        qtys[count] = qty_[i];
+        ++count;
+    }
+    for (std::size_t k = 0; count < want; ++k, ++count) {
+        prices[count] = tail_[k].price;
+        qtys[count] = static_cast<int>(tail_[k].qty);
+    }
+    return count;
+}
+
+template <std::size_t Window>
+std::size_t BasicPriceLadder<Window>::scan_up(std::size_t i) const
+{
+    const std::size_t words = (window() + 63) / 64;
+    std::size_t w = i >> 6;
+    if (w >= words) return npos;
+
+    std::uint64_t bits = occupied_[w] & (~std::uint64_t{0} << (i & 63));
+    while (bits == 0) {
+        if (++w == words) return npos;
+        bits = occupied_[w];
+    }
+    return (w << 6) + ladder_detail::lowest_bit(bits);
+}
+
+template <std::size_t Window>
+std::size_t BasicPriceLadder<Window>::scan_down(std::size_t i) const
+{
+    if (i == npos) return npos;
+
+    std::size_t w = i >> 6;
+    std::uint64_t bits = occupied_[w] & (~std::uint64_t{0} >> (63 - (i & 63)));
+    while (bits == 0) {
+        if (w == 0) return npos;
+        bits = occupied_[--w];
+    }
+    return (w << 6) + ladder_detail::highest_bit(bits);
+}
+
+template <std::size_t Window>
+void BasicPriceLadder<Window>::clear()
+{
+    std::fill(qty_.begin(), qty_.end(), 0);
+    rebuild_occupancy();
+    best_ = 0;
+    levels_ = 0;
+    total_ = depth5_ = depth10_ = 0;
+    tail_.clear();
+    tail_total_ = 0;
+    if (indexed_) rebuild_index();
+}
+
+template <std::size_t Window>
+void BasicPriceLadder<Window>::find_best_from(Tick start)
+{
+    // Caller guarantees at least one level remains, so the scan finds one
+    const std::size_t i = (side_ == Side::Bid) ? scan_down(index(start)) : scan_up(index(start));
+    best_ = base_ + static_cast<Tick>(i);
+}
+
+template <std::size_t Window>
+void BasicPriceLadder<Window>::rebuild_occupancy()
+{
+    if constexpr (Window == 0) {
+        occupied_.assign((window() + 63) / 64, 0);
+    } else {
+        occupied_.fill(0);
+    }
+    for (std::size_t i = 0; i < window(); ++i) {
+        if (qty_[i] != 0) mark(i);
+    }
+}
+
+template <std::size_t Window>
+void BasicPriceLadder<Window>::enable_index(bool on)
+{
+    indexed_ = on;
+    if (on) rebuild_index();
+}
+
+template <std::size_t Window>
+void BasicPriceLadder<Window>::rebuild_index()
+{
+    depth_index_.reset(window());
+    for (std::size_t i = scan_up(0); i != npos; i = scan_up(i + 1)) {
+        const Tick px = base_ + static_cast<Tick>(i);
+        depth_index_.set_raw(position(px), qty_[i], px * qty_[i]);
+    }
+    depth_index_.finish_build();
+}
+
+template <std::size_t Window>
+typename BasicPriceLadder<Window>::Sweep
+BasicPriceLadder<Window>::sweep(std::int64_t qty) const
+{
+    Sweep out;
+    if (qty <= 0 || levels_ == 0) return out;
+
+    const std::int64_t target = std::min<std::int64_t>(qty, total_);
+    out.filled = target;
+    std::int64_t remaining = target;
+
+    if (indexed_) {
+        // The index covers the window; whatever it cannot fill comes from the tail
+        const std::int64_t near = std::min(target, total_ - tail_total_);
+        std::int64_t qty_before = 0;
+        std::int64_t notional_before = 0;
+        const std::size_t pos = depth_index_.lower_bound(near, qty_before, notional_before);
+        out.last_price = price_at(pos);
+        out.notional = notional_before + (near - qty_before) * out.last_price;
+        remaining -= near;
+    } else {
+        for (std::size_t i = index(best_); remaining > 0 && i != npos; i = step_away(i)) {
+            const Tick px = base_ + static_cast<Tick>(i);
+            const std::int64_t take = std::min<std::int64_t>(qty_[i], remaining);
+            out.notional += take * px;
+            out.last_price = px;
+            remaining -= take;
+        }
+    }
+
+    for (std::size_t k = 0; remaining > 0; ++k) {
+        const std::int64_t take = std::min<std::int64_t>(tail_[k].qty, remaining);
+        out.notional += take * tail_[k].price;
+        out.last_price = tail_[k].price;
+        remaining -= take;
+    }
+    return out;
+}
+
+template <std::size_t Window>
+std::int64_t BasicPriceLadder<Window>::depth_within(Tick ticks) const
+{
+    if (ticks <= 0 || levels_ == 0) return 0;
+
+    std::int64_t sum = 0;
+    if (indexed_) {
+        // Positions ahead of the best are empty, so the prefix starts at the touch
+        const std::size_t last = position(best_) + static_cast<std::size_t>(ticks) - 1;
+        sum = depth_index_.prefix_qty(last);
+    } else {
+        const Tick step = (side_ == Side::Bid) ? -1 : 1;
+        for (Tick d = 0; d < ticks; ++d) {
+            const Tick p = best_ + d * step;
+            if (!in_window(p)) break;
+            sum += qty_[index(p)];
+        }
+    }
+
+    for (const FarLevel& l : tail_) {
+        if (distance(l.price) >= ticks) break;
+        sum += l.qty;
+    }
+    return sum;
+}
+
+template <std::size_t Window>
+void BasicPriceLadder<Window>::refresh_depth()
+{
+    depth5_ = depth10_ = 0;
+    const Tick step = (side_ == Side::Bid) ? -1 : 1;
+    for (Tick d = 0; d < kFarDepth; ++d) {
+        const std::int64_t q = qty_at(best_ + d * step);
+        if (d < kNearDepth) depth5_ += q;
+        depth10_ += q;
+    }
+}
+
+template <std::size_t Window>
+bool BasicPriceLadder<Window>::recenter(Tick price)
+{
+    // Range of live levels (plus the incoming price) that must survive the move
+    Tick live_lo = price;
+    Tick live_hi = price;
+    Tick old_lo = 0;
+    std::size_t old_count = 0;
+
+    if (levels_ > 0) {
+        const std::size_t first = scan_up(0);
+        const std::size_t last = scan_down(window() - 1);
+
+        old_lo = base_ + static_cast<Tick>(first);
+        old_count = last - first + 1;
+        live_lo = std::min(live_lo, old_lo);
+        live_hi = std::max(live_hi, base_ + static_cast<Tick>(last));
+    }
+
+    const std::size_t span = static_cast<std::size_t>(live_hi - live_lo) + 1;
+    std::size_t size = window();
+    if (Window) {
+        if (span > size) return false;   // fixed window: centre what fits
+    } else {
+        while (span * 2 > size) size *= 2;  // keep headroom on both sides
+        if (max_window_ != 0 && size > max_window_) {
+            if (span > max_window_) return false;
+            size = max_window_;
+        }
+    }
+
+    const Tick new_base = live_lo - static_cast<Tick>((size - span) / 2);
+
+    if (size != window()) {
+        if constexpr (Window == 0) {
+            std::vector<int> grown(size, 0);
+            if (old_count > 0) {
+                std::copy_n(&qty_[index(old_lo)], old_count,
+                            &grown[static_cast<std::size_t>(old_lo - new_base)]);
+            }
+            qty_.swap(grown);
+        }
+    } else if (old_count > 0) {
+        const std::size_t src = index(old_lo);
+        const std::size_t dst = static_cast<std::size_t>(old_lo - new_base);
+        std::memmove(&qty_[dst], &qty_[src], old_count * sizeof(int));
+        std::fill(qty_.begin(), qty_.begin() + static_cast<std::ptrdiff_t>(dst), int{0});
+        std::fill(qty_.begin() + static_cast<std::ptrdiff_t>(dst + old_count), qty_.end(), int{0});
+    } else {
+        std::fill(qty_.begin(), qty_.end(), int{0});
+    }
+
+    base_ = new_base;
+    rebuild_occupancy();
+    if (indexed_) rebuild_index();
+    return true;
+}
+
+template <std::size_t Window>
+int BasicPriceLadder<Window>::far_qty_at(Tick price) const
+{
+    const auto it = std::lower_bound(tail_.begin(), tail_.end(), price,
+                                     [this](const FarLevel& l, Tick p) { return better(l.price, p); });
+    return (it != tail_.end() && it->price == price) ? it->qty : 0;
+}
+
+template <std::size_t Window>
+void BasicPriceLadder<Window>::add_far(Tick price, int qty)
+{
+    const auto it = far_find(price);
+    if (it != tail_.end() && it->price == price) {
+        it->qty += qty;
+    } else {
+        tail_.insert(it, FarLevel{price, qty});
+        ++levels_;
+    }
+    total_ += qty;
+    tail_total_ += qty;
+    track_depth(price, qty);
+}
+
+template <std::size_t Window>
+int BasicPriceLadder<Window>::reduce_far(Tick price, int qty)
+{
+    const auto it = far_find(price);
+    if (it == tail_.end() || it->price != price) return 0;
+
+    const int removed = std::min(it->qty, qty);
+    it->qty -= removed;
+    total_ -= removed;
+    tail_total_ -= removed;
+    if (it->qty == 0) {
+        tail_.erase(it);
+        --levels_;   // the best level is in the window, so levels_ stays > 0
+    }
+    track_depth(price, -removed);
+    return removed;
+}
+
+template <std::size_t Window>
+bool BasicPriceLadder<Window>::near_far_edge() const
+{
+    // Fewer than kFarDepth slots left behind the touch
+    const Tick room = (side_ == Side::Bid)
+        ? best_ - base_
+        : base_ + static_cast<Tick>(window()) - 1 - best_;
+    return room < kFarDepth;
+}
+
+template <std::size_t Window>
+void BasicPriceLadder<Window>::rebase(Tick anchor, std::size_t size)
+{
+    moved_.clear();
+    for (std::size_t i = scan_up(0); i != npos; i = scan_up(i + 1)) {
+        moved_.push_back(FarLevel{base_ + static_cast<Tick>(i), qty_[i]});
+    }
+    moved_.insert(moved_.end(), tail_.begin(), tail_.end());
+    tail_.clear();
+    tail_total_ = 0;
+
+    if constexpr (Window == 0) {
+        qty_.assign(size, 0);
+    } else {
+        (void)size;
+        qty_.fill(0);
+    }
+
+    // The touch sits a quarter window from the aggressive edge: room to
+    // improve ahead of it, most of the window behind it
+    const Tick quarter = static_cast<Tick>(window() / 4);
+    base_ = (side_ == Side::Bid) ? anchor - static_cast<Tick>(window()) + quarter
+                                 : anchor - quarter;
+
+    for (const FarLevel& l : moved_) {
+        if (in_window(l.price)) {
+            qty_[index(l.price)] = l.qty;
+        } else {
+            tail_.push_back(l);
+            tail_total_ += l.qty;
+        }
+    }
+    std::sort(tail_.begin(), tail_.end(),
+              [this](const FarLevel& a, const FarLevel& b) { return better(a.price, b.price); });
+
+    rebuild_occupancy();
+    if (indexed_) rebuild_index();
+}
+
+template <std::size_t Window>
+void BasicPriceLadder<Window>::set_max_window(std::size_t ticks)
+{
+    if constexpr (Window == 0) {
+        max_window_ = ticks ? ladder_detail::round_up_pow2(ticks) : 0;
+        if (max_window_ != 0 && window() > max_window_) rebase(levels_ ? best_ : base_, max_window_);
+    } else {
+        (void)ticks;
+    }
+}
+
+// The runtime-sized ladder is compiled once, in price_ladder.cpp
+extern template class BasicPriceLadder<>;
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "event.h"
+#include "event_buffer.h"
+
+#include <cstddef>
 
 class EventProcess {
 public:
@@ -8,5 +11,17 @@ public:
 
     //Generates the next event, given current time t.
     virtual Event next(double t) = 0;
+
+    // Appends n events to a packed buffer, starting from time t.
+    // Returns the time of the last event (t if n == 0).
+    double generate(double t, std::size_t n, EventBuffer& out)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            const Event e = next(t);
+            t = e.t;
+            out.push(e);
+        }
+        return t;
+    }
 };
 
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+// Random number generators for the event processes, and the samplers they
+// draw through.
+//
+// Every process is templated on an RNG policy: a 64-bit
+// UniformRandomBitGenerator that can be built from a 64-bit seed, plus
+//   jump()                  advance to the start of the next non-overlapping
+//                           substream
+//   Rng::stream(seed, i)    substream i of seed (stream(seed, 0) == Rng(seed))
+// Splitting a seed into substreams, one per thread or forked path, gives the
+// same numbers however the work is later scheduled.
+//
+// Xoshiro256pp has 32 bytes of state and takes a few cycles per draw; the
+// processes default to BufferedRandom (random_buffer.h), which refills
+// blocks of uniforms and exponentials from vectorized xoshiro256++ lanes.
+// Philox4x32 is counter-based. Any substream and any position in it can be
+// reached in O(1), which suits splitting into very many streams.
+// std::mt19937_64 also works as a policy (without jump/stream).
+
+namespace rng_detail {
+
+inline std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+inline std::uint64_t splitmix64(std::uint64_t& state)
+{
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+}  // namespace rng_detail
+
+// xoshiro256++ (Blackman & Vigna), period 2^256 - 1. The state is filled
+// from the seed by splitmix64, as the authors recommend.
+class Xoshiro256pp {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256pp(std::uint64_t seed = 0) { this->seed(seed); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    void seed(std::uint64_t seed)
+    {
+        for (std::uint64_t& w : s_) w = rng_detail::splitmix64(seed);
+    }
+
+    result_type operator()()
+    {
+        const std::uint64_t result = rng_detail::rotl(s_[0] + s_[3], 23) + s_[0];
+        const std::uint64_t t = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = rng_detail::rotl(s_[3], 45);
+        return result;
+    }
+
+    // Advances 2^128 draws: up to 2^128 substreams of 2^128 draws each
+    void jump() { apply({0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                         0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL}); }
+
+    // Advances 2^192 draws, e.g. one level up when substreams are split again
+    void long_jump() { apply({0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+                              0x77710069854ee241ULL, 0x39109bb02acbe635ULL}); }
+
+    // O(index) jumps: sequential callers should copy a generator and jump()
+    // it once per stream instead
+    static Xoshiro256pp stream(std::uint64_t seed, std::uint64_t index)
+    {
+        Xoshiro256pp g(seed);
+        for (; index > 0; --index) g.jump();
+        return g;
+    }
+
+    // Raw state, e.g. to step several generators side by side in vector
+    // registers (see random_buffer.h)
+    using State = std::array<std::uint64_t, 4>;
+    State state() const { return {s_[0], s_[1], s_[2], s_[3]}; }
+    void restore(const State& st)
+    {
+        for (int k = 0; k < 4; ++k) s_[k] = st[k];
+    }
+
+    bool operator==(const Xoshiro256pp& o) const
+    {
+        return s_[0] == o.s_[0] && s_[1] == o.s_[1] && s_[2] == o.s_[2] && s_[3] == o.s_[3];
+    }
+    bool operator!=(const Xoshiro256pp& o) const { return !(*this == o); }
+
+private:
+    std::uint64_t s_[4];
+
+    struct Polynomial { std::uint64_t w[4]; };
+
+    void apply(const Polynomial& p)
+    {
+        std::uint64_t acc[4] = {0, 0, 0, 0};
+        for (const std::uint64_t word : p.w) {
+            for (int b = 0; b < 64; ++b) {
+                if (word & (std::uint64_t{1} << b)) {
+                    for (int k = 0; k < 4; ++k) acc[k] ^= s_[k];
+                }
+                (*this)();
+            }
+        }
+        for (int k = 0; k < 4; ++k) s_[k] = acc[k];
+    }
+};
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as
+// 1, 2, 3"): draw n of stream s is a keyed bijection of the 128-bit counter
+// (s, n / 2), so streams and positions are reached in O(1). Each counter
+// value yields four 32-bit words, returned as two 64-bit draws.
+class Philox4x32 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Philox4x32(std::uint64_t seed = 0, std::uint64_t stream = 0)
+    {
+        this->seed(seed, stream);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    void seed(std::uint64_t seed, std::uint64_t stream = 0)
+    {
+        key_[0] = static_cast<std::uint32_t>(seed);
+        key_[1] = static_cast<std::uint32_t>(seed >> 32);
+        stream_ = stream;
+        block_ = 0;
+        used_ = 2;
+    }
+
+    result_type operator()()
+    {
+        if (used_ == 2) refill();
+        return out_[used_++];
+    }
+
+    // Skips n draws in O(1)
+    void discard(std::uint64_t n)
+    {
+        // Position as a draw index within the stream
+        const std::uint64_t at = (used_ == 2 ? block_ * 2 : (block_ - 1) * 2 + used_) + n;
+        block_ = at / 2;
+        used_ = 2;
+        if (at % 2 != 0) {
+            refill();
+            used_ = 1;
+        }
+    }
+
+    // Moves to the start of the next stream (2^65 draws each)
+    void jump()
+    {
+        ++stream_;
+        block_ = 0;
+        used_ = 2;
+    }
+
+    static Philox4x32 stream(std::uint64_t seed, std::uint64_t index)
+    {
+        return Philox4x32(seed, index);
+    }
+
+    // Raw block function: the four output words for one counter value
+    static void block(const std::uint32_t counter[4], const std::uint32_t key[2],
+                      std::uint32_t out[4])
+    {
+        std::uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+        std::uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; ++round) {
+            const std::uint64_t p0 = std::uint64_t{0xD2511F53u} * c0;
+            const std::uint64_t p1 = std::uint64_t{0xCD9E8D57u} * c2;
+            const std::uint32_t n0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            const std::uint32_t n2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c1 = static_cast<std::uint32_t>(p1);
+            c3 = static_cast<std::uint32_t>(p0);
+            c0 = n0;
+            c2 = n2;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+    bool operator==(const Philox4x32& o) const
+    {
+        // The buffered draws follow from the key and position
+        return key_[0] == o.key_[0] && key_[1] == o.key_[1] && stream_ == o.stream_ &&
+               block_ == o.block_ && used_ == o.used_;
+    }
+    bool operator!=(const Philox4x32& o) const { return !(*this == o); }
+
+private:
+    std::uint32_t key_[2];
+    std::uint64_t stream_ = 0;
+    std::uint64_t block_ = 0;   // next counter value to encrypt
+    std::uint64_t out_[2] = {0, 0};
+    unsigned used_ = 2;         // draws taken from out_
+
+    void refill()
+    {
+        const std::uint32_t counter[4] = {
+            static_cast<std::uint32_t>(block_), static_cast<std::uint32_t>(block_ >> 32),
+            static_cast<std::uint32_t>(stream_), static_cast<std::uint32_t>(stream_ >> 32)};
+        std::uint32_t words[4];
+        block(counter, key_, words);
+        out_[0] = words[0] | (std::uint64_t{words[1]} << 32);
+        out_[1] = words[2] | (std::uint64_t{words[3]} << 32);
+        ++block_;
+        used_ = 0;
+    }
+};
+
+// Samplers. They need a generator with 64 uniform bits per call, and
+// replace the <random> distributions, which are slower and not guaranteed
+// to give the same numbers across standard libraries.
+namespace rng {
+
+template <typename Rng>
+inline constexpr bool is_64bit =
+    Rng::min() == 0 && Rng::max() == std::numeric_limits<std::uint64_t>::max();
+
+// Generators that keep pre-drawn uniforms and Exp(1) variates (see
+// random_buffer.h) hand those out instead of converting bits per call
+template <typename Rng, typename = void>
+inline constexpr bool is_buffered = false;
+template <typename Rng>
+inline constexpr bool is_buffered<Rng, std::void_t<decltype(std::declval<Rng&>().exponential())>> =
+    true;
+
+// Uniform on [0, 1): the top 53 bits
+template <typename Rng>
+inline double uniform01(Rng& g)
+{
+    if constexpr (is_buffered<Rng>) {
+        return g.uniform();
+    } else {
+        static_assert(is_64bit<Rng>, "RNG policy must produce 64 uniform bits per call");
+        return static_cast<double>(g() >> 11) * 0x1.0p-53;
+    }
+}
+
+// Uniform on (0, 1], so std::log never sees 0
+template <typename Rng>
+inline double uniform_open01(Rng& g)
+{
+    if constexpr (is_buffered<Rng>) {
+        return 1.0 - g.uniform();
+    } else {
+        static_assert(is_64bit<Rng>, "RNG policy must produce 64 uniform bits per call");
+        return static_cast<double>((g() >> 11) + 1) * 0x1.0p-53;
+    }
+}
+
+// Exp(rate)
+template <typename Rng>
+inline double exponential(Rng& g, double rate)
+{
+    if constexpr (is_buffered<Rng>) {
+        return g.exponential() / rate;
+    } else {
+        return -std::log(uniform_open01(g)) / rate;
+    }
+}
+
+template <typename Rng>
+inline bool bernoulli(Rng& g, double p)
+{
+    return uniform01(g) < p;
+}
+
+// Poisson(mean), mean <= 0 gives 0. Below mean 10, inversion by sequential
+// search (one uniform, about mean + 1 steps); above it, Hormann's PTRS
+// transformed rejection ("The transformed rejection method for generating
+// Poisson random variables", 1993), which takes about 1.1 uniform pairs
+// whatever the mean.
+template <typename Rng>
+inline std::int64_t poisson(Rng& g, double mean)
+{
+    if (!(mean > 0.0)) return 0;
+
+    if (mean < 10.0) {
+        const double u = uniform01(g);
+        double p = std::exp(-mean);
+        double cdf = p;
+        std::int64_t k = 0;
+        while (u >= cdf && p > 0.0) {
+            ++k;
+            p *= mean / static_cast<double>(k);
+            cdf += p;
+        }
+        return k;
+    }
+
+    const double slam = std::sqrt(mean);
+    const double loglam = std::log(mean);
+    const double b = 0.931 + 2.53 * slam;
+    const double a = -0.059 + 0.02483 * b;
+    const double inv_alpha = 1.1239 + 1.1328 / (b - 3.4);
+    const double vr = 0.9277 - 3.6224 / (b - 2.0);
+
+    for (;;) {
+        const double u = uniform01(g) - 0.5;
+        const double v = uniform_open01(g);
+        const double us = 0.5 - std::fabs(u);
+        const double k = std::floor((2.0 * a / us + b) * u + mean + 0.43);
+
+        if (us >= 0.07 && v <= vr) return static_cast<std::int64_t>(k);
+        if (k < 0.0 || (us < 0.013 && v > us)) continue;
+        if (std::log(v) + std::log(inv_alpha) - std::log(a / (us * us) + b) <=
+            -mean + k * loglam - std::lgamma(k + 1.0)) {
+            return static_cast<std::int64_t>(k);
+        }
+    }
+}
+
+// Uniform integer on [lo, hi], unbiased (Lemire's multiply-and-reject on
+// the top 32 bits; the rejection loop almost never runs). An empty range
+// (hi < lo) returns lo without drawing.
+template <typename Rng>
+inline int uniform_int(Rng& g, int lo, int hi)
+{
+    static_assert(is_64bit<Rng>, "RNG policy must produce 64 uniform bits per call");
+    if (hi < lo) return lo;
+    const std::uint64_t span = static_cast<std::uint64_t>(static_cast<std::int64_t>(hi) - lo) + 1;
+    if (span > 0xffffffffULL) return static_cast<int>(g() >> 32);   // full int range
+
+    const std::uint32_t range = static_cast<std::uint32_t>(span);
+    std::uint64_t m = (g() >> 32) * range;
+    std::uint32_t low = static_cast<std::uint32_t>(m);
+    if (low < range) {
+        const std::uint32_t threshold = static_cast<std::uint32_t>(-range) % range;
+        while (low < threshold) {
+            m = (g() >> 32) * range;
+            low = static_cast<std::uint32_t>(m);
+        }
+    }
+    return static_cast<int>(static_cast<std::int64_t>(lo) + static_cast<std::int64_t>(m >> 32));
+}
+
+}  // namespace rng
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "order_book.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// What readers of a SnapshotPublisher see: the N best levels per side plus
+// the time of the event that produced them.
+template <std::size_t N>
+struct BookView {
+    DepthSnapshot<N> depth{};
+    double t = 0.0;              // time of the last applied event
+    std::uint64_t version = 0;   // number of publishes so far (0 = never)
+};
+
+// Single-writer / multi-reader publication of top-N book snapshots (seqlock).
+//
+// The simulator thread calls publish() after each apply(); any number of
+// other threads call read() or try_read() without taking a lock. The writer
+// never waits: it bumps the sequence to odd, stores the view word by word
+// and bumps it back to even. A reader copies the words and retries if the
+// sequence was odd or moved while it was copying.
+//
+// The payload is kept in relaxed atomic words so concurrent copies are
+// well-defined; on x86/ARM these compile to plain loads and stores.
+template <std::size_t N>
+class SnapshotPublisher {
+public:
+    using View = BookView<N>;
+    static_assert(std::is_trivially_copyable<View>::value, "View must be trivially copyable");
+
+    // Writer side (one thread only). Book is any book with snapshot<N>():
+    // OrderBook, a BasicOrderBook specialization, or BookManager::book(id).
+    template <typename Book>
+    void publish(const Book& book, double t)
+    {
+        book.snapshot(staging_.depth);
+        staging_.t = t;
+        staging_.version += 1;
+        store(staging_);
+    }
+
+    // Reader side: spins until a consistent copy is obtained
+    void read(View& out) const
+    {
+        while (!try_read(out)) {
+        }
+    }
+
+    // Single attempt; returns false if a publish was in progress or overlapped
+    bool try_read(View& out) const
+    {
+        const std::uint64_t before = seq_.load(std::memory_order_acquire);
+        if (before & 1u) return false;
+
+        std::uint64_t words[kWords];
+        for (std::size_t i = 0; i < kWords; ++i) {
+            words[i] = payload_[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != before) return false;
+
+        std::memcpy(&out, words, sizeof(View));
+        return true;
+    }
+
+    // Number of completed publishes (cheap change check for pollers)
+    std::uint64_t version() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr std::size_t kWords = (sizeof(View) + 7) / 8;
+
+    alignas(64) std::atomic<std::uint64_t> seq_{0};
+    alignas(64) std::atomic<std::uint64_t> payload_[kWords] = {};
+    View staging_{};   // writer-private
+
+    void store(const View& v)
+    {
+        std::uint64_t words[kWords] = {};
+        std::memcpy(words, &v, sizeof(View));
+
+        const std::uint64_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < kWords; ++i) {
+            payload_[i].store(words[i], std::memory_order_relaxed);
+        }
+        seq_.store(s + 2, std::memory_order_release);
+    }
+};
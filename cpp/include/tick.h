@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// Prices are carried as integer multiples of an instrument's tick size.
+// Conversion to/from double only happens at configuration and output time.
+using Tick = std::int64_t;
+
+inline Tick to_ticks(double price, double tick_size)
+{
+    return static_cast<Tick>(std::llround(price / tick_size));
+}
+
+inline double to_price(Tick ticks, double tick_size)
+{
+    return static_cast<double>(ticks) * tick_size;
+}
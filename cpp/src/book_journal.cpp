@@ -0,0 +1,171 @@
+#include "book_journal.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace {
+
+constexpr char kMagic[4] = {'L', 'O', 'B', 'J'};
+constexpr std::uint32_t kVersion = 2;   // 2: phase changes, phase in snapshots
+
+template <typename T>
+void write_pod(std::ofstream& out, const T& x)
+{
+    out.write(reinterpret_cast<const char*>(&x), sizeof(T));
+}
+
+template <typename T>
+void write_array(std::ofstream& out, const T* data, std::size_t n)
+{
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(n * sizeof(T)));
+}
+
+template <typename T>
+bool read_pod(std::ifstream& in, T& x)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&x), sizeof(T)));
+}
+
+template <typename T>
+bool read_vector(std::ifstream& in, std::vector<T>& v, std::uint64_t n)
+{
+    v.resize(static_cast<std::size_t>(n));
+    return static_cast<bool>(
+        in.read(reinterpret_cast<char*>(v.data()), static_cast<std::streamsize>(n * sizeof(T))));
+}
+
+// Takes n elements of `size` bytes from the bytes left in the file; false if
+// they do not fit (checked by division, so a corrupt count cannot overflow)
+bool take(std::uint64_t& remaining, std::uint64_t n, std::uint64_t size)
+{
+    if (n > remaining / size) return false;
+    remaining -= n * size;
+    return true;
+}
+
+}  // namespace
+
+BookJournal::BookJournal(std::size_t snapshot_every)
+    : every_(snapshot_every > 0 ? snapshot_every : 1)
+{
+}
+
+void BookJournal::clear()
+{
+    events_.clear();
+    snapshots_.clear();
+    changes_.clear();
+    level_price_.clear();
+    level_qty_.clear();
+}
+
+bool BookJournal::save(const std::string& path) const
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+
+    const std::uint64_t n = events_.size();
+    const std::uint64_t every = every_;
+    const std::uint64_t snapshots = snapshots_.size();
+    const std::uint64_t levels = level_price_.size();
+    const std::uint64_t changes = changes_.size();
+
+    out.write(kMagic, sizeof(kMagic));
+    write_pod(out, kVersion);
+    write_pod(out, tick_size_);
+    write_pod(out, every);
+    write_pod(out, n);
+    write_pod(out, snapshots);
+    write_pod(out, levels);
+    write_pod(out, changes);
+
+    write_array(out, events_.stamps(), n);
+    write_array(out, events_.prices(), n);
+    write_array(out, events_.quantities(), n);
+    write_array(out, snapshots_.data(), snapshots_.size());
+    write_array(out, level_price_.data(), level_price_.size());
+    write_array(out, level_qty_.data(), level_qty_.size());
+    write_array(out, changes_.data(), changes_.size());
+
+    return static_cast<bool>(out);
+}
+
+bool BookJournal::load(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[4];
+    std::uint32_t version = 0;
+    double tick_size = 0.0;
+    std::uint64_t every = 0, n = 0, snapshots = 0, levels = 0, changes = 0;
+
+    if (!in.read(magic, sizeof(magic)) ||
+        !std::equal(magic, magic + 4, kMagic) ||
+        !read_pod(in, version) || version != kVersion ||
+        !read_pod(in, tick_size) || !read_pod(in, every) || every == 0 ||
+        !read_pod(in, n) || !read_pod(in, snapshots) || !read_pod(in, levels) ||
+        !read_pod(in, changes)) {
+        return false;
+    }
+
+    // The counts size the buffers below: check them against what the file
+    // actually holds before allocating anything
+    const std::streamoff header_end = in.tellg();
+    in.seekg(0, std::ios::end);
+    const std::streamoff file_end = in.tellg();
+    in.seekg(header_end);
+    if (header_end < 0 || file_end < header_end || !in) return false;
+
+    std::uint64_t remaining = static_cast<std::uint64_t>(file_end - header_end);
+    if (!take(remaining, n, sizeof(std::uint64_t) + 2 * sizeof(std::int32_t)) ||
+        !take(remaining, snapshots, sizeof(Snapshot)) ||
+        !take(remaining, levels, sizeof(Tick) + sizeof(int)) ||
+        !take(remaining, changes, sizeof(PhaseChange))) {
+        return false;
+    }
+
+    std::vector<std::uint64_t> stamps;
+    std::vector<std::int32_t> prices, qtys;
+    std::vector<Snapshot> snaps;
+    std::vector<PhaseChange> phase_changes;
+    std::vector<Tick> level_price;
+    std::vector<int> level_qty;
+
+    if (!read_vector(in, stamps, n) || !read_vector(in, prices, n) || !read_vector(in, qtys, n) ||
+        !read_vector(in, snaps, snapshots) ||
+        !read_vector(in, level_price, levels) || !read_vector(in, level_qty, levels) ||
+        !read_vector(in, phase_changes, changes)) {
+        return false;
+    }
+    for (const Snapshot& s : snaps) {
+        if (s.offset > levels || s.bid_count + std::uint64_t{s.ask_count} > levels - s.offset ||
+            s.phase > 1) {
+            return false;
+        }
+    }
+    for (std::size_t k = 0; k < phase_changes.size(); ++k) {
+        const PhaseChange& c = phase_changes[k];
+        if (c.index > n || (k > 0 && c.index < phase_changes[k - 1].index) ||
+            (c.kind != kBeginAuction && c.kind != kUncross)) {
+            return false;
+        }
+    }
+
+    clear();
+    every_ = static_cast<std::size_t>(every);
+    tick_size_ = tick_size;
+    events_.reserve(stamps.size());
+    for (std::size_t i = 0; i < stamps.size(); ++i) {
+        PackedEvent p;
+        p.stamp = stamps[i];
+        p.price = prices[i];
+        p.qty = qtys[i];
+        events_.push(p);
+    }
+    snapshots_.swap(snaps);
+    changes_.swap(phase_changes);
+    level_price_.swap(level_price);
+    level_qty_.swap(level_qty);
+    return true;
+}
@@ -0,0 +1,99 @@
+#include "book_manager.h"
+
+#include <limits>
+
+BookManager::BookManager(std::size_t expected_instruments)
+{
+    books_.reserve(expected_instruments);
+    tick_size_.reserve(expected_instruments);
+    best_bid_.reserve(expected_instruments);
+    best_ask_.reserve(expected_instruments);
+    bid_qty_.reserve(expected_instruments);
+    ask_qty_.reserve(expected_instruments);
+    is_dirty_.reserve(expected_instruments);
+}
+
+InstrumentId BookManager::add_instrument(double tick_size)
+{
+    books_.emplace_back(tick_size);
+    tick_size_.push_back(books_.back().tick_size());  // after OrderBook's fallback
+    best_bid_.push_back(0);
+    best_ask_.push_back(0);
+    bid_qty_.push_back(0);
+    ask_qty_.push_back(0);
+    is_dirty_.push_back(0);
+    return static_cast<InstrumentId>(books_.size() - 1);
+}
+
+void BookManager::refresh(InstrumentId id) const
+{
+    const TopOfBook tob = books_[id].top();
+    best_bid_[id] = tob.best_bid_price.value_or(0);
+    best_ask_[id] = tob.best_ask_price.value_or(0);
+    bid_qty_[id]  = tob.best_bid_qty.value_or(0);
+    ask_qty_[id]  = tob.best_ask_qty.value_or(0);
+}
+
+bool BookManager::apply(const Event& e)
+{
+    if (e.instrument >= books_.size()) return false;
+
+    const bool ok = books_[e.instrument].apply(e);
+    if (ok) mark(e.instrument);
+    return ok;
+}
+
+void BookManager::sync() const
+{
+    for (const InstrumentId id : dirty_) {
+        refresh(id);
+        is_dirty_[id] = 0;
+    }
+    dirty_.clear();
+}
+
+std::size_t BookManager::apply_batch(const Event* events, std::size_t n)
+{
+    std::size_t accepted = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        accepted += apply(events[i]);
+    }
+    return accepted;
+}
+
+void BookManager::mids(double* out) const
+{
+    sync();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const std::size_t n = books_.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        const bool both = best_bid_[i] != 0 && best_ask_[i] != 0;
+        const double mid = 0.5 * static_cast<double>(best_bid_[i] + best_ask_[i]) * tick_size_[i];
+        out[i] = both ? mid : nan;
+    }
+}
+
+void BookManager::spreads(double* out) const
+{
+    sync();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const std::size_t n = books_.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        const bool both = best_bid_[i] != 0 && best_ask_[i] != 0;
+        const double spread = static_cast<double>(best_ask_[i] - best_bid_[i]) * tick_size_[i];
+        out[i] = both ? spread : nan;
+    }
+}
+
+void BookManager::imbalances(double* out) const
+{
+    sync();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const std::size_t n = books_.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        const bool both = best_bid_[i] != 0 && best_ask_[i] != 0;
+        const double qb = static_cast<double>(bid_qty_[i]);
+        const double qa = static_cast<double>(ask_qty_[i]);
+        out[i] = both ? (qb - qa) / (qb + qa) : nan;
+    }
+}
@@ -1,9 +1,11 @@
 #include "csv_logger.h"
 
+#include <cmath>
 #include <iomanip>
 
-CsvLogger::CsvLogger(const std::string& path)
-    : out_(path)
+CsvLogger::CsvLogger(const std::string& path, double tick_size)
+    : out_(path),
+      tick_size_(tick_size)
 {
     out_ << std::setprecision(10);
 }
@@ -29,10 +31,10 @@ void CsvLogger::log(double t,
          << static_cast<int>(e.type) << ","
          << static_cast<int>(e.side) << ","
          << e.quantity << ","
-         << e.price << ","
-         << opt_num(tob.best_bid_price) << ","
+         << to_price(e.price, tick_size_) << ","
+         << opt_price(tob.best_bid_price) << ","
          << opt_int(tob.best_bid_qty) << ","
-         << opt_num(tob.best_ask_price) << ","
+         << opt_price(tob.best_ask_price) << ","
          << opt_int(tob.best_ask_qty) << ","
          << opt_num(m.mid) << ","
          << opt_num(m.spread) << ","
@@ -40,6 +42,43 @@ void CsvLogger::log(double t,
          << "\n";
 }
 
+void CsvLogger::log_batch(const EventBuffer& events, const BookSeries& series)
+{
+    auto price_at = [&](const Tick* col, std::size_t i) -> std::optional<Tick> {
+        if (!col || col[i] == 0) return std::nullopt;
+        return col[i];
+    };
+    auto qty_at = [](const int* col, const Tick* px, std::size_t i) -> std::optional<int> {
+        if (!col || !px || px[i] == 0) return std::nullopt;
+        return col[i];
+    };
+    auto num_at = [](const double* col, std::size_t i) -> std::optional<double> {
+        if (!col || std::isnan(col[i])) return std::nullopt;
+        return col[i];
+    };
+
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        TopOfBook tob{};
+        tob.best_bid_price = price_at(series.best_bid, i);
+        tob.best_bid_qty   = qty_at(series.best_bid_qty, series.best_bid, i);
+        tob.best_ask_price = price_at(series.best_ask, i);
+        tob.best_ask_qty   = qty_at(series.best_ask_qty, series.best_ask, i);
+
+        Metrics m{};
+        m.mid            = num_at(series.mid, i);
+        m.spread         = num_at(series.spread, i);
+        m.imbalance_top1 = num_at(series.imbalance_top1, i);
+
+        const Event e = events[i];
+        log(e.t, e, tob, m);
+    }
+}
+
+std::string CsvLogger::opt_price(const std::optional<Tick>& x) const
+{
+    return x ? std::to_string(to_price(*x, tick_size_)) : "";
+}
+
 std::string CsvLogger::opt_num(const std::optional<double>& x)
 {
     return x ? std::to_string(*x) : "";
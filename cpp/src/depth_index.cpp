@@ -0,0 +1,59 @@
+#include "depth_index.h"
+
+#include <algorithm>
+
+void DepthIndex::reset(std::size_t size)
+{
+    size_ = size;
+    qty_.assign(size + 1, 0);
+    notional_.assign(size + 1, 0);
+}
+
+void DepthIndex::finish_build()
+{
+    // Linear-time construction: push each node's partial sum to its parent
+    for (std::size_t i = 1; i <= size_; ++i) {
+        const std::size_t parent = i + (i & (~i + 1));
+        if (parent <= size_) {
+            qty_[parent] += qty_[i];
+            notional_[parent] += notional_[i];
+        }
+    }
+}
+
+void DepthIndex::update(std::size_t pos, std::int64_t dqty, std::int64_t dnotional)
+{
+    for (std::size_t i = pos + 1; i <= size_; i += i & (~i + 1)) {
+        qty_[i] += dqty;
+        notional_[i] += dnotional;
+    }
+}
+
+std::int64_t DepthIndex::prefix_qty(std::size_t pos) const
+{
+    std::int64_t sum = 0;
+    for (std::size_t i = std::min(pos + 1, size_); i > 0; i -= i & (~i + 1)) {
+        sum += qty_[i];
+    }
+    return sum;
+}
+
+std::size_t DepthIndex::lower_bound(std::int64_t target,
+                                    std::int64_t& qty_before,
+                                    std::int64_t& notional_before) const
+{
+    // Binary descent: extend the covered prefix while it stays below target
+    std::size_t pos = 0;
+    qty_before = 0;
+    notional_before = 0;
+
+    for (std::size_t step = size_; step > 0; step >>= 1) {
+        const std::size_t next = pos + step;
+        if (next <= size_ && qty_before + qty_[next] < target) {
+            pos = next;
+            qty_before += qty_[next];
+            notional_before += notional_[next];
+        }
+    }
+    return pos;  // 0-based position of the level that reaches target
+}
@@ -0,0 +1,265 @@
+#include "hawkes_cluster_generator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace {
+
+// Expected immigrants per block: enough work to amortize seeding a block's
+// RNG, small enough to balance the load across threads
+constexpr double kImmigrantsPerBlock = 4096.0;
+
+// Bounds the width of the k-way merge on very long horizons
+constexpr std::size_t kMaxBlocks = std::size_t{1} << 16;
+
+// Whether the nonnegative matrix m (column-major, dim x dim) has spectral
+// radius below 1. Then and only then I - m is a nonsingular M-matrix, i.e.
+// all its leading principal minors are positive, which is the same as
+// Gaussian elimination without pivoting finding only positive pivots.
+bool subcritical(const std::vector<double>& m, std::size_t dim)
+{
+    std::vector<double> a(dim * dim);   // I - m, row-major
+    for (std::size_t i = 0; i < dim; ++i) {
+        for (std::size_t j = 0; j < dim; ++j) {
+            a[i * dim + j] = (i == j ? 1.0 : 0.0) - m[j * dim + i];
+        }
+    }
+
+    for (std::size_t k = 0; k < dim; ++k) {
+        const double pivot = a[k * dim + k];
+        if (!(pivot > 0.0)) return false;
+        for (std::size_t i = k + 1; i < dim; ++i) {
+            const double f = a[i * dim + k] / pivot;
+            if (f == 0.0) continue;
+            for (std::size_t j = k; j < dim; ++j) a[i * dim + j] -= f * a[k * dim + j];
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+HawkesClusterGenerator::HawkesClusterGenerator(
+    const std::vector<double>& mu,
+    const std::vector<std::vector<double>>& alpha,
+    const std::vector<std::vector<double>>& beta,
+    int qty_min,
+    int qty_max,
+    unsigned seed,
+    const std::vector<EventMapping>& mapping
+)
+    : dim_(mu.size()),
+      mu_(mu),
+      qty_min_(qty_min),
+      qty_max_(qty_max),
+      seed_(seed)
+{
+    if (dim_ == 0)
+        throw std::invalid_argument("Hawkes process needs at least one dimension");
+
+    if (alpha.size() != dim_ || beta.size() != dim_)
+        throw std::invalid_argument("alpha/beta matrices must be dim x dim");
+
+    for (std::size_t i = 0; i < dim_; ++i) {
+        if (alpha[i].size() != dim_ || beta[i].size() != dim_)
+            throw std::invalid_argument("alpha/beta rows must have one entry per dimension");
+    }
+
+    if (mapping.empty() && dim_ % kDefaultEventMapping.size() != 0)
+        throw std::invalid_argument("an event mapping is required unless dim is a multiple of 6");
+
+    if (!mapping.empty() && mapping.size() != dim_)
+        throw std::invalid_argument("event mapping must have one entry per dimension");
+
+    mapping_.resize(dim_);
+    mean_.assign(dim_ * dim_, 0.0);
+    beta_.assign(dim_ * dim_, 0.0);
+    children_.assign(dim_, 0.0);
+
+    for (std::size_t i = 0; i < dim_; ++i) {
+        if (!std::isfinite(mu[i]) || mu[i] <= 0.0)
+            throw std::invalid_argument("All baseline intensities mu must be finite and positive");
+        mapping_[i] = mapping.empty() ? kDefaultEventMapping[i % kDefaultEventMapping.size()]
+                                      : mapping[i];
+        for (std::size_t j = 0; j < dim_; ++j) {
+            if (!std::isfinite(alpha[i][j]) || alpha[i][j] < 0.0)
+                throw std::invalid_argument("cluster sampling needs finite alpha >= 0");
+            if (!std::isfinite(beta[i][j]) || beta[i][j] <= 0.0)
+                throw std::invalid_argument("cluster sampling needs finite beta > 0");
+            mean_[j * dim_ + i] = alpha[i][j] / beta[i][j];
+            beta_[j * dim_ + i] = beta[i][j];
+            children_[j] += mean_[j * dim_ + i];
+        }
+    }
+
+    if (!subcritical(mean_, dim_))
+        throw std::invalid_argument(
+            "cluster sampling needs a branching ratio (spectral radius of alpha / beta) below 1");
+}
+
+void HawkesClusterGenerator::simulate_block(std::size_t block, double lo, double hi,
+                                            double horizon, std::vector<Event>& out) const
+{
+    // Counter-based: substream `block` of the seed, reached in O(1)
+    Philox4x32 rng = Philox4x32::stream(seed_, block);
+
+    std::vector<Birth> births;
+
+    // Immigrants: Poisson counts, uniform times within the block
+    for (std::size_t i = 0; i < dim_; ++i) {
+        for (std::int64_t n = rng::poisson(rng, mu_[i] * (hi - lo)); n > 0; --n) {
+            births.push_back({lo + (hi - lo) * rng::uniform01(rng), static_cast<std::uint32_t>(i)});
+        }
+    }
+
+    // Offspring, generation by generation: births doubles as the work queue
+
+    for (std::size_t q = 0; q < births.size(); ++q) {
+        const Birth parent = births[q];   // copied: push_back may reallocate
+        const std::size_t j = parent.dim;
+        if (!(children_[j] > 0.0)) continue;
+
+        const double* mean = &mean_[j * dim_];
+        const double* rate = &beta_[j * dim_];
+        for (std::int64_t n = rng::poisson(rng, children_[j]); n > 0; --n) {
+            // Target dimension with probability mean[i] / children_[j]
+            const double u = rng::uniform01(rng) * children_[j];
+            std::size_t i = 0;
+            double acc = mean[0];
+            while (u >= acc && i + 1 < dim_) acc += mean[++i];
+
+            const double t = parent.t + rng::exponential(rng, rate[i]);
+            if (t < horizon) births.push_back({t, static_cast<std::uint32_t>(i)});
+        }
+    }
+
+    // Sort by time: distribute into about one bucket per event over
+    // [lo, latest], then sort the (short) buckets. A comparison sort of the
+    // whole block was a third of the cost.
+    const std::size_t n = births.size();
+    double latest = lo;
+    for (const Birth& b : births) latest = std::max(latest, b.t);
+    const double scale = latest > lo ? static_cast<double>(n) / (latest - lo) : 0.0;
+    auto bucket = [&](const Birth& b) {
+        return std::min(n - 1, static_cast<std::size_t>((b.t - lo) * scale));
+    };
+
+    std::vector<std::size_t> start(n + 1, 0);
+    for (const Birth& b : births) ++start[bucket(b) + 1];
+    for (std::size_t k = 0; k < n; ++k) start[k + 1] += start[k];
+
+    std::vector<Birth> sorted(n);
+    std::vector<std::size_t> fill(start.begin(), start.end() - 1);
+    for (const Birth& b : births) sorted[fill[bucket(b)]++] = b;
+
+    for (std::size_t k = 0; k < n; ++k) {
+        if (start[k + 1] - start[k] > 1) {
+            std::sort(sorted.begin() + start[k], sorted.begin() + start[k + 1],
+                      [](const Birth& a, const Birth& b) {
+                          return a.t < b.t || (a.t == b.t && a.dim < b.dim);
+                      });
+        }
+    }
+
+    // Quantities are drawn in time order so a block's output is reproducible
+    out.clear();
+    out.reserve(n);
+    for (const Birth& b : sorted) {
+        Event e{};
+        e.t = b.t;
+        e.quantity = rng::uniform_int(rng, qty_min_, qty_max_);
+        e.price = 0;  // Will be set by simulator for Add/Cancel
+        e.type = mapping_[b.dim].type;
+        e.side = mapping_[b.dim].side;
+        out.push_back(e);
+    }
+}
+
+std::size_t HawkesClusterGenerator::generate(double horizon, EventBuffer& out,
+                                             unsigned threads) const
+{
+    if (!std::isfinite(horizon) || horizon < 0.0)
+        throw std::invalid_argument("horizon must be finite and non-negative");
+    if (horizon == 0.0) return 0;
+
+    // Block layout depends only on the parameters, never on the thread count
+    double immigrant_rate = 0.0;
+    for (double m : mu_) immigrant_rate += m;
+    const double expected = std::ceil(immigrant_rate * horizon / kImmigrantsPerBlock);
+    const std::size_t blocks =
+        expected >= static_cast<double>(kMaxBlocks)
+            ? kMaxBlocks
+            : std::max<std::size_t>(1, static_cast<std::size_t>(expected));
+    const double width = horizon / static_cast<double>(blocks);
+
+    std::vector<std::vector<Event>> parts(blocks);
+
+    // Workers pull blocks off a shared counter until none are left
+    std::atomic<std::size_t> next_block{0};
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+    auto work = [&] {
+        try {
+            for (std::size_t b; (b = next_block.fetch_add(1)) < blocks;) {
+                const double lo = static_cast<double>(b) * width;
+                const double hi = b + 1 == blocks ? horizon : static_cast<double>(b + 1) * width;
+                simulate_block(b, lo, hi, horizon, parts[b]);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failure_mutex);
+            if (!failure) failure = std::current_exception();
+            next_block = blocks;   // stop the others early
+        }
+    };
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t workers = std::min<std::size_t>(threads, blocks);
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (std::size_t w = 1; w < workers; ++w) pool.emplace_back(work);
+    work();
+    for (std::thread& th : pool) th.join();
+    if (failure) std::rethrow_exception(failure);
+
+    // k-way merge by time; ties go to the earlier block, so the order is fixed
+    std::size_t total = 0;
+    for (const auto& part : parts) total += part.size();
+    out.reserve(out.size() + total);
+
+    using Head = std::pair<double, std::size_t>;   // (time, block)
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    std::vector<std::size_t> pos(blocks, 0);
+    for (std::size_t b = 0; b < blocks; ++b) {
+        if (!parts[b].empty()) heads.push({parts[b][0].t, b});
+    }
+
+    // Blocks only overlap where clusters spill past their block's end, so
+    // the popped block is drained in runs until another head comes first
+    while (!heads.empty()) {
+        const std::size_t b = heads.top().second;
+        heads.pop();
+        const std::vector<Event>& part = parts[b];
+        std::size_t i = pos[b];
+        do {
+            out.push(part[i++]);
+        } while (i < part.size() && (heads.empty() || Head{part[i].t, b} < heads.top()));
+
+        if (i < part.size()) {
+            pos[b] = i;
+            heads.push({part[i].t, b});
+        } else {
+            std::vector<Event>().swap(parts[b]);   // release drained blocks early
+        }
+    }
+
+    return total;
+}
@@ -0,0 +1,7 @@
+#include "hawkes_exact_process.h"
+
+// Explicit instantiations: the univariate process, the runtime-dimension
+// multivariate one and the classic 6-D one
+template class BasicHawkesUnivariateExactProcess<>;
+template class BasicHawkesMultivariateExactProcess<>;
+template class BasicHawkesMultivariateExactProcess<6>;
@@ -0,0 +1,257 @@
+#include "order_book_l3.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*
+Core principles (in addition to OrderBook's):
+- Aggregated quantities live in the PriceLadders; queues hold the same total
+- Orders are pooled and linked by index, the pool only grows
+- Fills are recorded per resting order, in time priority
+*/
+
+OrderBookL3::OrderBookL3(double tick_size, std::size_t expected_orders)
+    : tick_size_(tick_size),
+      bids_(Side::Bid),
+      asks_(Side::Ask),
+      index_(expected_orders),
+      bid_queues_(64),
+      ask_queues_(64)
+{
+    if (!(tick_size_ > 0.0) || !std::isfinite(tick_size_)) {
+        tick_size_ = 0.1;  // sane fallback
+    }
+    pool_.reserve(expected_orders);
+    fills_.reserve(64);
+}
+
+std::uint32_t OrderBookL3::allocate()
+{
+    if (free_ != npos) {
+        const std::uint32_t slot = free_;
+        free_ = pool_[slot].next;
+        return slot;
+    }
+    pool_.emplace_back();
+    return static_cast<std::uint32_t>(pool_.size() - 1);
+}
+
+void OrderBookL3::release(std::uint32_t slot)
+{
+    pool_[slot].next = free_;
+    free_ = slot;
+}
+
+void OrderBookL3::push_back(LevelQueue& q, std::uint32_t slot)
+{
+    Order& o = pool_[slot];
+    o.prev = q.tail;
+    o.next = npos;
+    if (q.tail != npos) pool_[q.tail].next = slot;
+    else q.head = slot;
+    q.tail = slot;
+}
+
+void OrderBookL3::unlink(LevelQueue& q, std::uint32_t slot)
+{
+    Order& o = pool_[slot];
+    if (o.prev != npos) pool_[o.prev].next = o.next;
+    else q.head = o.next;
+    if (o.next != npos) pool_[o.next].prev = o.prev;
+    else q.tail = o.prev;
+}
+
+void OrderBookL3::remove_order(LevelQueue& q, std::uint32_t slot)
+{
+    const Order& o = pool_[slot];
+
+    unlink(q, slot);
+    if (q.head == npos) queues(o.side).erase(o.price);  // invalidates q
+
+    index_.erase(o.id);
+    release(slot);
+}
+
+OrderId OrderBookL3::add_resting(Side side, Tick price, int qty)
+{
+    const std::uint32_t slot = allocate();
+    Order& o = pool_[slot];
+    o.id = next_id_++;
+    o.price = price;
+    o.qty = qty;
+    o.side = side;
+
+    push_back(queues(side)[price], slot);
+    index_[o.id] = slot;
+    ladder(side).add(price, qty);
+    return o.id;
+}
+
+void OrderBookL3::cancel_level_qty(Side side, Tick price, int qty)
+{
+    LevelQueue* q = queues(side).find(price);
+    if (!q) return;
+
+    PriceLadder& lad = ladder(side);
+    while (qty > 0) {
+        // Most recent order first; q stays valid because nothing is inserted
+        const std::uint32_t slot = q->tail;
+        Order& o = pool_[slot];
+        const int take = std::min(o.qty, qty);
+
+        o.qty -= take;
+        qty -= take;
+        lad.reduce(price, take);
+
+        if (o.qty == 0) {
+            const bool last = (q->head == slot);
+            remove_order(*q, slot);
+            if (last) return;
+        }
+    }
+}
+
+void OrderBookL3::consume_best(Side book_side, int qty)
+{
+    PriceLadder& lad = ladder(book_side);
+    auto& side_queues = queues(book_side);
+
+    while (qty > 0 && !lad.empty()) {
+        const Tick px = lad.best();
+        LevelQueue* q = side_queues.find(px);
+
+        while (qty > 0) {
+            const std::uint32_t slot = q->head;
+            Order& o = pool_[slot];
+            const int take = std::min(o.qty, qty);
+
+            o.qty -= take;
+            qty -= take;
+            lad.reduce(px, take);
+            fills_.push_back({o.id, px, take, o.qty == 0});
+
+            if (o.qty == 0) {
+                const bool last = (q->tail == slot);
+                remove_order(*q, slot);
+                if (last) break;  // level exhausted, ladder has moved on
+            }
+        }
+    }
+}
+
+OrderId OrderBookL3::add(Side side, Tick price, int qty)
+{
+    fills_.clear();
+    if (qty <= 0 || price <= 0) return 0;
+
+    if (side == Side::Bid) {
+        if (!asks_.empty() && price >= asks_.best()) {
+            consume_best(Side::Ask, qty);
+            return 0;
+        }
+    } else {
+        if (!bids_.empty() && price <= bids_.best()) {
+            consume_best(Side::Bid, qty);
+            return 0;
+        }
+    }
+    return add_resting(side, price, qty);
+}
+
+bool OrderBookL3::cancel(OrderId id)
+{
+    const std::uint32_t* slot = index_.find(id);
+    if (!slot) return false;
+
+    const std::uint32_t s = *slot;
+    const Order& o = pool_[s];
+    ladder(o.side).reduce(o.price, o.qty);
+    remove_order(*queues(o.side).find(o.price), s);
+    return true;
+}
+
+bool OrderBookL3::modify(OrderId id, int new_qty)
+{
+    if (new_qty <= 0) return cancel(id);
+
+    const std::uint32_t* slot = index_.find(id);
+    if (!slot) return false;
+
+    const std::uint32_t s = *slot;
+    Order& o = pool_[s];
+    PriceLadder& lad = ladder(o.side);
+
+    if (new_qty < o.qty) {
+        lad.reduce(o.price, o.qty - new_qty);    // keeps priority
+    } else if (new_qty > o.qty) {
+        lad.add(o.price, new_qty - o.qty);       // loses priority
+        LevelQueue* q = queues(o.side).find(o.price);
+        unlink(*q, s);
+        push_back(*q, s);
+    }
+    o.qty = new_qty;
+    return true;
+}
+
+std::optional<int> OrderBookL3::queue_ahead(OrderId id) const
+{
+    const std::uint32_t* slot = index_.find(id);
+    if (!slot) return std::nullopt;
+
+    int ahead = 0;
+    for (std::uint32_t s = pool_[*slot].prev; s != npos; s = pool_[s].prev) {
+        ahead += pool_[s].qty;
+    }
+    return ahead;
+}
+
+bool OrderBookL3::apply(const Event& e)
+{
+    fills_.clear();
+    if (!std::isfinite(e.t) || e.quantity <= 0) return false;
+
+    switch (e.type) {
+        case EventType::Add: {
+            if (e.price <= 0) return false;
+            add(e.side, e.price, e.quantity);
+            return true;
+        }
+
+        case EventType::Cancel: {
+            if (e.price <= 0) return false;
+            cancel_level_qty(e.side, e.price, e.quantity);
+            return true;
+        }
+
+        case EventType::Market: {
+            // Market Buy consumes asks, Market Sell consumes bids
+            consume_best(e.side == Side::Bid ? Side::Ask : Side::Bid, e.quantity);
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+TopOfBook OrderBookL3::top() const
+{
+    TopOfBook tob{};
+
+    if (!bids_.empty()) {
+        tob.best_bid_price = bids_.best();
+        tob.best_bid_qty   = bids_.best_qty();
+    }
+
+    if (!asks_.empty()) {
+        tob.best_ask_price = asks_.best();
+        tob.best_ask_qty   = asks_.best_qty();
+    }
+
+    return tob;
+}
+
+Metrics OrderBookL3::metrics() const
+{
+    return book_metrics(top(), tick_size_);
+}
@@ -0,0 +1,4 @@
+#include "price_ladder.h"
+
+// Explicit instantiation of the runtime-sized ladder (see extern template)
+template class BasicPriceLadder<>;
@@ -0,0 +1,354 @@
+#include "random_buffer.h"
+
+#include <cstring>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+// GCC 12's AVX-512 intrinsics trip -Wuninitialized on their own placeholders
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+namespace {
+
+// A draw's top 52 bits under exponent 0 give a double in [1, 2)
+constexpr std::uint64_t kOneBits = 0x3FF0000000000000ULL;
+constexpr std::uint64_t kMantissa = 0x000FFFFFFFFFFFFFULL;
+
+// Adding 2^52 bits to a small integer reads it back as 2^52 + n
+constexpr std::uint64_t kMagicBits = 0x4330000000000000ULL;
+constexpr double kMagic = 0x1.0p52;
+
+// ln(y) for y in (0, 1]: y = 2^e * m with m in [sqrt(1/2), sqrt(2)), and
+// ln(m) = 2 atanh(z), z = (m - 1) / (m + 1), |z| < 0.172, by its odd series
+// up to z^21 (relative error below 1e-16). ln2 is split so e * kLn2Hi is
+// exact.
+constexpr double kSqrt2 = 1.4142135623730951;
+constexpr double kLn2Hi = 0.693145751953125;
+constexpr double kLn2Lo = 1.42860682030941723212e-6;
+
+// 1/21, 1/19, ..., 1/3
+constexpr double kSeries[10] = {
+    1.0 / 21, 1.0 / 19, 1.0 / 17, 1.0 / 15, 1.0 / 13,
+    1.0 / 11, 1.0 / 9,  1.0 / 7,  1.0 / 5,  1.0 / 3,
+};
+
+using LaneState = std::uint64_t[4][BufferedRandom::kLanes];
+
+#if defined(__AVX512F__)
+
+inline __m512d neg_log(__m512d y)
+{
+    const __m512i bits = _mm512_castpd_si512(y);
+    __m512d e = _mm512_sub_pd(
+        _mm512_castsi512_pd(_mm512_or_si512(_mm512_srli_epi64(bits, 52), _mm512_set1_epi64(kMagicBits))),
+        _mm512_set1_pd(kMagic + 1023.0));
+    __m512d m = _mm512_castsi512_pd(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi64(kMantissa)),
+                                                    _mm512_set1_epi64(kOneBits)));
+    const __mmask8 big = _mm512_cmp_pd_mask(m, _mm512_set1_pd(kSqrt2), _CMP_GT_OQ);
+    m = _mm512_mask_mul_pd(m, big, m, _mm512_set1_pd(0.5));
+    e = _mm512_mask_add_pd(e, big, e, _mm512_set1_pd(1.0));
+
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d z = _mm512_div_pd(_mm512_sub_pd(m, one), _mm512_add_pd(m, one));
+    const __m512d w = _mm512_mul_pd(z, z);
+    __m512d p = _mm512_set1_pd(kSeries[0]);
+    for (int j = 1; j < 10; ++j) p = _mm512_add_pd(_mm512_mul_pd(p, w), _mm512_set1_pd(kSeries[j]));
+    const __m512d z2 = _mm512_add_pd(z, z);
+    const __m512d ln_m = _mm512_add_pd(z2, _mm512_mul_pd(_mm512_mul_pd(z2, w), p));
+
+    const __m512d ln = _mm512_add_pd(_mm512_mul_pd(e, _mm512_set1_pd(kLn2Hi)),
+                                     _mm512_add_pd(ln_m, _mm512_mul_pd(e, _mm512_set1_pd(kLn2Lo))));
+    return _mm512_sub_pd(_mm512_setzero_pd(), ln);
+}
+
+// kLanes = 8 generators in one register per state word
+template <bool Exponential>
+void fill(LaneState& st, double* out)
+{
+    __m512i s0 = _mm512_loadu_si512(st[0]);
+    __m512i s1 = _mm512_loadu_si512(st[1]);
+    __m512i s2 = _mm512_loadu_si512(st[2]);
+    __m512i s3 = _mm512_loadu_si512(st[3]);
+    const __m512i one_bits = _mm512_set1_epi64(kOneBits);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d two = _mm512_set1_pd(2.0);
+
+    for (std::size_t i = 0; i < BufferedRandom::kBlock; i += 8) {
+        const __m512i r = _mm512_add_epi64(_mm512_rol_epi64(_mm512_add_epi64(s0, s3), 23), s0);
+        const __m512i t = _mm512_slli_epi64(s1, 17);
+        s2 = _mm512_xor_si512(s2, s0);
+        s3 = _mm512_xor_si512(s3, s1);
+        s1 = _mm512_xor_si512(s1, s2);
+        s0 = _mm512_xor_si512(s0, s3);
+        s2 = _mm512_xor_si512(s2, t);
+        s3 = _mm512_rol_epi64(s3, 45);
+
+        const __m512d x = _mm512_castsi512_pd(_mm512_or_si512(_mm512_srli_epi64(r, 12), one_bits));
+        if constexpr (Exponential) {
+            _mm512_storeu_pd(out + i, neg_log(_mm512_sub_pd(two, x)));
+        } else {
+            _mm512_storeu_pd(out + i, _mm512_sub_pd(x, one));
+        }
+    }
+
+    _mm512_storeu_si512(st[0], s0);
+    _mm512_storeu_si512(st[1], s1);
+    _mm512_storeu_si512(st[2], s2);
+    _mm512_storeu_si512(st[3], s3);
+}
+
+#elif defined(__AVX2__)
+
+inline __m256i rotl(__m256i x, int k)
+{
+    return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+}
+
+inline __m256d neg_log(__m256d y)
+{
+    const __m256i bits = _mm256_castpd_si256(y);
+    __m256d e = _mm256_sub_pd(
+        _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(kMagicBits))),
+        _mm256_set1_pd(kMagic + 1023.0));
+    __m256d m = _mm256_castsi256_pd(_mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi64x(kMantissa)), _mm256_set1_epi64x(kOneBits)));
+    const __m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(kSqrt2), _CMP_GT_OQ);
+    m = _mm256_sub_pd(m, _mm256_and_pd(big, _mm256_mul_pd(m, _mm256_set1_pd(0.5))));
+    e = _mm256_add_pd(e, _mm256_and_pd(big, _mm256_set1_pd(1.0)));
+
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d z = _mm256_div_pd(_mm256_sub_pd(m, one), _mm256_add_pd(m, one));
+    const __m256d w = _mm256_mul_pd(z, z);
+    __m256d p = _mm256_set1_pd(kSeries[0]);
+    for (int j = 1; j < 10; ++j) p = _mm256_add_pd(_mm256_mul_pd(p, w), _mm256_set1_pd(kSeries[j]));
+    const __m256d z2 = _mm256_add_pd(z, z);
+    const __m256d ln_m = _mm256_add_pd(z2, _mm256_mul_pd(_mm256_mul_pd(z2, w), p));
+
+    const __m256d ln = _mm256_add_pd(_mm256_mul_pd(e, _mm256_set1_pd(kLn2Hi)),
+                                     _mm256_add_pd(ln_m, _mm256_mul_pd(e, _mm256_set1_pd(kLn2Lo))));
+    return _mm256_sub_pd(_mm256_setzero_pd(), ln);
+}
+
+// The kLanes = 8 generators as two halves of 4
+template <bool Exponential>
+void fill(LaneState& st, double* out)
+{
+    __m256i s[2][4];
+    for (int h = 0; h < 2; ++h) {
+        for (int w = 0; w < 4; ++w) {
+            s[h][w] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(st[w] + 4 * h));
+        }
+    }
+    const __m256i one_bits = _mm256_set1_epi64x(kOneBits);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+
+    for (std::size_t i = 0; i < BufferedRandom::kBlock; i += 8) {
+        for (int h = 0; h < 2; ++h) {
+            __m256i& s0 = s[h][0];
+            __m256i& s1 = s[h][1];
+            __m256i& s2 = s[h][2];
+            __m256i& s3 = s[h][3];
+            const __m256i r = _mm256_add_epi64(rotl(_mm256_add_epi64(s0, s3), 23), s0);
+            const __m256i t = _mm256_slli_epi64(s1, 17);
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = rotl(s3, 45);
+
+            const __m256d x = _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(r, 12), one_bits));
+            if constexpr (Exponential) {
+                _mm256_storeu_pd(out + i + 4 * h, neg_log(_mm256_sub_pd(two, x)));
+            } else {
+                _mm256_storeu_pd(out + i + 4 * h, _mm256_sub_pd(x, one));
+            }
+        }
+    }
+
+    for (int h = 0; h < 2; ++h) {
+        for (int w = 0; w < 4; ++w) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(st[w] + 4 * h), s[h][w]);
+        }
+    }
+}
+
+#else
+
+inline double from_bits(std::uint64_t b)
+{
+    double d;
+    std::memcpy(&d, &b, sizeof d);
+    return d;
+}
+
+inline std::uint64_t to_bits(double d)
+{
+    std::uint64_t b;
+    std::memcpy(&b, &d, sizeof b);
+    return b;
+}
+
+// Same reduction and series as the vector paths
+inline double neg_log(double y)
+{
+    const std::uint64_t bits = to_bits(y);
+    double e = from_bits((bits >> 52) | kMagicBits) - (kMagic + 1023.0);
+    double m = from_bits((bits & kMantissa) | kOneBits);
+    // Branch-free and fully unrolled, so the caller's loop can vectorize
+    const double big = m > kSqrt2 ? 1.0 : 0.0;
+    m -= big * 0.5 * m;
+    e += big;
+    const double z = (m - 1.0) / (m + 1.0);
+    const double w = z * z;
+    const double p = ((((((((kSeries[0] * w + kSeries[1]) * w + kSeries[2]) * w + kSeries[3]) * w +
+                          kSeries[4]) * w + kSeries[5]) * w + kSeries[6]) * w + kSeries[7]) * w +
+                      kSeries[8]) * w + kSeries[9];
+    const double z2 = z + z;
+    const double ln_m = z2 + z2 * w * p;
+    return 0.0 - (e * kLn2Hi + (ln_m + e * kLn2Lo));
+}
+
+template <bool Exponential>
+void fill(LaneState& st, double* out)
+{
+    constexpr std::size_t L = BufferedRandom::kLanes;
+    for (std::size_t i = 0; i < BufferedRandom::kBlock; i += L) {
+        for (std::size_t k = 0; k < L; ++k) {
+            std::uint64_t& s0 = st[0][k];
+            std::uint64_t& s1 = st[1][k];
+            std::uint64_t& s2 = st[2][k];
+            std::uint64_t& s3 = st[3][k];
+            const std::uint64_t r = rng_detail::rotl(s0 + s3, 23) + s0;
+            const std::uint64_t t = s1 << 17;
+            s2 ^= s0;
+            s3 ^= s1;
+            s1 ^= s2;
+            s0 ^= s3;
+            s2 ^= t;
+            s3 = rng_detail::rotl(s3, 45);
+
+            out[i + k] = from_bits((r >> 12) | kOneBits) - 1.0;
+        }
+    }
+    if constexpr (Exponential) {
+        for (std::size_t i = 0; i < BufferedRandom::kBlock; ++i) out[i] = neg_log(1.0 - out[i]);
+    }
+}
+
+#endif
+
+void load_lanes(Xoshiro256pp& g, LaneState& st)
+{
+    for (std::size_t k = 0; k < BufferedRandom::kLanes; ++k) {
+        const Xoshiro256pp::State words = g.state();
+        for (int w = 0; w < 4; ++w) st[w][k] = words[w];
+        g.jump();
+    }
+}
+
+void long_jump_lanes(LaneState& st)
+{
+    Xoshiro256pp g;
+    for (std::size_t k = 0; k < BufferedRandom::kLanes; ++k) {
+        g.restore({st[0][k], st[1][k], st[2][k], st[3][k]});
+        g.long_jump();
+        const Xoshiro256pp::State words = g.state();
+        for (int w = 0; w < 4; ++w) st[w][k] = words[w];
+    }
+}
+
+}  // namespace
+
+void BufferedRandom::seed(std::uint64_t seed)
+{
+    // Substreams 0 .. kLanes-1 for the uniforms, then kLanes .. 2*kLanes-1
+    Xoshiro256pp g(seed);
+    load_lanes(g, u_.lanes);
+    load_lanes(g, e_.lanes);
+    u_.next = e_.next = kBlock;
+    u_.resume = e_.resume = 0;
+}
+
+void BufferedRandom::jump()
+{
+    // A copy that has not drawn yet still has to step past its block
+    if (u_.resume != 0) refill_uniform();
+    if (e_.resume != 0) refill_exponential();
+    long_jump_lanes(u_.lanes);
+    long_jump_lanes(e_.lanes);
+    u_.next = e_.next = kBlock;
+}
+
+namespace {
+
+// Where a buffer's next draw comes from: the lanes its block starts at and
+// the entry within that block
+template <typename Cursor>
+std::pair<const LaneState*, std::size_t> position(const Cursor& c)
+{
+    if (c.next != BufferedRandom::kBlock) return {&c.start, c.next};
+    return {&c.lanes, c.resume};
+}
+
+template <typename Cursor>
+void copy_cursor(Cursor& to, const Cursor& from)
+{
+    const auto [lanes, entry] = position(from);
+    std::memcpy(to.lanes, *lanes, sizeof(LaneState));
+    to.next = BufferedRandom::kBlock;
+    to.resume = entry;
+}
+
+template <typename Cursor>
+bool same_position(const Cursor& a, const Cursor& b)
+{
+    const auto [la, ia] = position(a);
+    const auto [lb, ib] = position(b);
+    return ia == ib && std::memcmp(*la, *lb, sizeof(LaneState)) == 0;
+}
+
+// Draws the block at c.lanes into out and moves the cursor onto it
+template <bool Exponential, typename Cursor>
+void refill(Cursor& c, double* out)
+{
+    std::memcpy(c.start, c.lanes, sizeof(LaneState));
+    fill<Exponential>(c.lanes, out);
+    c.next = c.resume;
+    c.resume = 0;
+}
+
+}  // namespace
+
+void BufferedRandom::copy_position(const BufferedRandom& o)
+{
+    copy_cursor(u_, o.u_);
+    copy_cursor(e_, o.e_);
+}
+
+bool BufferedRandom::operator==(const BufferedRandom& o) const
+{
+    // The unread entries follow from the lane states and the cursors
+    return same_position(u_, o.u_) && same_position(e_, o.e_);
+}
+
+void BufferedRandom::refill_uniform()
+{
+    if (!blocks_) blocks_ = std::make_unique<Blocks>();
+    refill<false>(u_, blocks_->u.data());
+}
+
+void BufferedRandom::refill_exponential()
+{
+    if (!blocks_) blocks_ = std::make_unique<Blocks>();
+    refill<true>(e_, blocks_->e.data());
+}
@@ -2,13 +2,297 @@
 #include <pybind11/stl.h>  // For automatic STL conversions
 #include <pybind11/numpy.h>  // For numpy array support
 
-#include <random>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include "order_book.h"
 #include "event.h"
 #include "hawkes_multivariate_process.h"
+#include "hawkes_exact_process.h"
+#include "rng.h"
 
 namespace py = pybind11;
 
+// Per-event depth analytics (NaN while either side is empty), recorded only
+// with analytics=True
+struct AnalyticsColumns {
+    std::vector<double> microprice;
+    std::vector<double> imbalance_depth5;
+    std::vector<double> imbalance_depth10;
+
+    void record(const ExtendedMetrics& m)
+    {
+        microprice.push_back(m.microprice ? *m.microprice : std::nan(""));
+        imbalance_depth5.push_back(m.imbalance_depth5 ? *m.imbalance_depth5 : std::nan(""));
+        imbalance_depth10.push_back(m.imbalance_depth10 ? *m.imbalance_depth10 : std::nan(""));
+    }
+
+    void export_to(py::dict& results) const
+    {
+        results["microprice"] = microprice;
+        results["imbalance_depth5"] = imbalance_depth5;
+        results["imbalance_depth10"] = imbalance_depth10;
+    }
+};
+
+static std::vector<py::ssize_t> matrix_shape(std::size_t rows, std::size_t cols)
+{
+    return {static_cast<py::ssize_t>(rows), static_cast<py::ssize_t>(cols)};
+}
+
+// Optional L2 history: (num_events x levels) price/qty matrices preallocated
+// as NumPy arrays and filled in place. Missing levels are NaN / 0.
+class DepthColumns {
+public:
+    DepthColumns(std::size_t rows, std::size_t levels)
+        : levels_(levels),
+          bid_px_(matrix_shape(rows, levels)),
+          bid_qty_(matrix_shape(rows, levels)),
+          ask_px_(matrix_shape(rows, levels)),
+          ask_qty_(matrix_shape(rows, levels)),
+          ticks_(levels)
+    {
+    }
+
+    void record(std::size_t row, const OrderBook& book)
+    {
+        if (levels_ == 0) return;
+        const std::size_t offset = row * levels_;
+        write_side(book, Side::Bid, bid_px_.mutable_data() + offset, bid_qty_.mutable_data() + offset);
+        write_side(book, Side::Ask, ask_px_.mutable_data() + offset, ask_qty_.mutable_data() + offset);
+    }
+
+    void export_to(py::dict& results) const
+    {
+        if (levels_ == 0) return;
+        results["bid_px"] = bid_px_;
+        results["bid_qty"] = bid_qty_;
+        results["ask_px"] = ask_px_;
+        results["ask_qty"] = ask_qty_;
+    }
+
+private:
+    std::size_t levels_;
+    py::array_t<double> bid_px_;
+    py::array_t<int> bid_qty_;
+    py::array_t<double> ask_px_;
+    py::array_t<int> ask_qty_;
+    std::vector<Tick> ticks_;   // scratch row, reused for every event
+
+    void write_side(const OrderBook& book, Side side, double* px, int* qty)
+    {
+        const std::size_t n = book.depth(side, ticks_.data(), qty, levels_);
+        for (std::size_t i = 0; i < n; ++i) px[i] = book.to_price(ticks_[i]);
+        for (std::size_t i = n; i < levels_; ++i) {
+            px[i] = std::nan("");
+            qty[i] = 0;
+        }
+    }
+};
+
+// Per-event top of book written by OrderBook::apply_batch() in the same pass
+// as the event. Best prices stay in ticks until export (0 = empty side, NaN
+// in the output).
+class TouchColumns {
+public:
+    explicit TouchColumns(std::size_t rows)
+        : bid_(rows), ask_(rows), mid_(rows), spread_(rows)
+    {
+    }
+
+    // The simulation loops feed each event's book back into the next event,
+    // so they apply one event per batch
+    void apply(OrderBook& book, const Event& e, std::size_t row)
+    {
+        BookSeries out;
+        out.best_bid = &bid_[row];
+        out.best_ask = &ask_[row];
+        out.mid = &mid_[row];
+        out.spread = &spread_[row];
+        book.apply_batch(&e, 1, out);
+    }
+
+    void export_to(py::dict& results, const OrderBook& book) const
+    {
+        std::vector<double> best_bid(bid_.size());
+        std::vector<double> best_ask(ask_.size());
+        for (std::size_t i = 0; i < bid_.size(); ++i) {
+            best_bid[i] = bid_[i] ? book.to_price(bid_[i]) : std::nan("");
+            best_ask[i] = ask_[i] ? book.to_price(ask_[i]) : std::nan("");
+        }
+        results["best_bid"] = best_bid;
+        results["best_ask"] = best_ask;
+        results["mid"] = mid_;
+        results["spread"] = spread_;
+    }
+
+private:
+    std::vector<Tick> bid_;
+    std::vector<Tick> ask_;
+    std::vector<double> mid_;
+    std::vector<double> spread_;
+};
+
+// Per-event execution columns: filled quantity, VWAP and slippage (in price
+// units) for aggressive orders; 0 / NaN for passive events. Only filled
+// with fills=True, since the FillSink costs a report per swept level.
+struct ExecutionColumns {
+    std::vector<int> fill_qty;
+    std::vector<int> unfilled;
+    std::vector<int> levels_swept;
+    std::vector<double> fill_vwap;
+    std::vector<double> slippage;
+
+    void record(const FillSink& sink, double tick_size)
+    {
+        if (sink.executions().empty()) {
+            fill_qty.push_back(0);
+            unfilled.push_back(0);
+            levels_swept.push_back(0);
+            fill_vwap.push_back(std::nan(""));
+            slippage.push_back(std::nan(""));
+            return;
+        }
+        const Execution& x = sink.executions().front();
+        fill_qty.push_back(x.filled);
+        unfilled.push_back(x.residual);
+        levels_swept.push_back(x.levels);
+        fill_vwap.push_back(x.filled > 0 ? x.vwap_ticks() * tick_size : std::nan(""));
+        slippage.push_back(x.filled > 0 ? x.slippage_ticks() * tick_size : std::nan(""));
+    }
+
+    void export_to(py::dict& results) const
+    {
+        results["fill_qty"] = fill_qty;
+        results["unfilled"] = unfilled;
+        results["levels_swept"] = levels_swept;
+        results["fill_vwap"] = fill_vwap;
+        results["slippage"] = slippage;
+    }
+};
+
+// Seeds 10 levels of 60 lots on each side of the centre
+static void seed_book(OrderBook& book, Tick center)
+{
+    for (int k = 1; k <= 10; ++k) {
+        book.apply({0.0, center - k, 60, EventType::Add, Side::Bid});
+        book.apply({0.0, center + k, 60, EventType::Add, Side::Ask});
+    }
+}
+
+// State-dependent Hawkes weights: wide spreads attract liquidity provision,
+// tight spreads attract aggressive orders. Dimensions are weighted by what
+// they map to, so any process dimension works.
+static std::vector<double> book_weights(const OrderBook& book,
+                                        const HawkesMultivariateProcess& process)
+{
+    std::vector<double> w(process.dim(), 1.0);
+    const TopOfBook tob = book.top();
+
+    if (!tob.best_bid_price || !tob.best_ask_price) {
+        return w;
+    }
+
+    const double spread_ticks =
+        static_cast<double>(*tob.best_ask_price - *tob.best_bid_price);
+
+    const double wide = 1.0 + 0.8 * spread_ticks;
+    const double tight = 1.0 + 2.5 / (1.0 + spread_ticks);
+
+    for (std::size_t k = 0; k < w.size(); ++k) {
+        const EventType type = process.mapping(k).type;
+        if (type == EventType::Add) w[k] = wide;          // Bid/Ask Add
+        else if (type == EventType::Market) w[k] = tight; // Market Buy/Sell
+    }
+
+    return w;
+}
+
+// Placement draws from the Hawkes process's RNG policy, on its own substream
+using PlacementRng = HawkesMultivariateProcess::Generator;
+
+// Keeps the book two-sided, then prices Add/Cancel events relative to the touch
+static void place_event(OrderBook& book, Event& e, Tick center, PlacementRng& place_rng)
+{
+    // Safety: keep book alive
+    TopOfBook tob = book.top();
+    if (!tob.best_bid_price) {
+        book.apply({e.t, center - 1, 50, EventType::Add, Side::Bid});
+    }
+    if (!tob.best_ask_price) {
+        book.apply({e.t, center + 1, 50, EventType::Add, Side::Ask});
+    }
+
+    tob = book.top();
+    const Tick best_bid = *tob.best_bid_price;
+    const Tick best_ask = *tob.best_ask_price;
+
+    const Tick spread_ticks = best_ask - best_bid;
+
+    // Realistic placement logic
+    if (e.type == EventType::Add) {
+        double improve_prob = (spread_ticks >= 3) ? 0.45 : 0.20;
+        double join_prob = 0.50;
+
+        int roll = rng::uniform_int(place_rng, 0, 99);
+
+        if (e.side == Side::Bid) {
+            // Try to improve the bid
+            if (roll < static_cast<int>(improve_prob * 100) && (best_bid + 1 < best_ask)) {
+                e.price = best_bid + 1;
+            }
+            // Join the best bid
+            else if (roll < static_cast<int>((improve_prob + join_prob) * 100)) {
+                e.price = best_bid;
+            }
+            // Place behind the best bid
+            else {
+                int depth = rng::uniform_int(place_rng, 1, 5);
+                e.price = best_bid - depth;
+            }
+        } else {  // Ask side
+            // Try to improve the ask
+            if (roll < static_cast<int>(improve_prob * 100) && (best_ask - 1 > best_bid)) {
+                e.price = best_ask - 1;
+            }
+            // Join the best ask
+            else if (roll < static_cast<int>((improve_prob + join_prob) * 100)) {
+                e.price = best_ask;
+            }
+            // Place behind the best ask
+            else {
+                int depth = rng::uniform_int(place_rng, 1, 5);
+                e.price = best_ask + depth;
+            }
+        }
+    } else if (e.type == EventType::Cancel) {
+        e.price = (e.side == Side::Bid) ? best_bid : best_ask;
+    }
+}
+
+// Event engine selected from Python: "thinning" (Ogata) or "exact"
+// (Dassios-Zhao, no rejected candidates). Both share the State type, so
+// checkpoints and forks work the same way.
+static std::unique_ptr<HawkesMultivariateProcess> make_process(
+    const std::string& engine,
+    const std::vector<double>& mu,
+    const std::vector<std::vector<double>>& alpha,
+    const std::vector<std::vector<double>>& beta,
+    int qty_min,
+    int qty_max,
+    unsigned seed
+) {
+    if (engine == "thinning") {
+        return std::make_unique<HawkesMultivariateProcess>(mu, alpha, beta, qty_min, qty_max, seed);
+    }
+    if (engine == "exact") {
+        return std::make_unique<HawkesMultivariateExactProcess>(mu, alpha, beta, qty_min, qty_max, seed);
+    }
+    throw std::invalid_argument("engine must be 'thinning' or 'exact'");
+}
+
 // Helper function to run a simulation and return results as Python dict
 py::dict run_simulation(
     const std::vector<double>& mu,
@@ -19,19 +303,24 @@ py::dict run_simulation(
     double tick_size,
     int qty_min,
     int qty_max,
-    unsigned seed
+    unsigned seed,
+    int depth_levels,
+    const std::string& engine,
+    bool fills,
+    bool analytics
 ) {
-    // Create order book
+    // Create order book (prices are integer ticks until output)
     OrderBook book(tick_size);
+    const Tick center = to_ticks(price_center, tick_size);
     
     // Seed initial book depth
-    for (int k = 1; k <= 10; ++k) {
-        book.apply({0.0, EventType::Add, Side::Bid, price_center - k * tick_size, 60});
-        book.apply({0.0, EventType::Add, Side::Ask, price_center + k * tick_size, 60});
-    }
+    seed_book(book, center);
     
     // Create Hawkes process
-    HawkesMultivariateProcess process(mu, alpha, beta, qty_min, qty_max, seed);
+    auto process = make_process(engine, mu, alpha, beta, qty_min, qty_max, seed);
+
+    // Placement uses substream 1 of the seed (the process draws from 0)
+    PlacementRng place_rng = PlacementRng::stream(seed, 1);
     
     // Storage for results
     std::vector<double> times;
@@ -39,126 +328,41 @@ py::dict run_simulation(
     std::vector<int> sides;
     std::vector<int> quantities;
     std::vector<double> prices;
-    std::vector<double> best_bids;
-    std::vector<double> best_asks;
-    std::vector<double> mids;
-    std::vector<double> spreads;
+    TouchColumns touch(static_cast<std::size_t>(std::max(num_events, 0)));
+    ExecutionColumns executions;
+    AnalyticsColumns depth_analytics;
+    DepthColumns l2_history(static_cast<std::size_t>(std::max(num_events, 0)),
+                            static_cast<std::size_t>(std::max(depth_levels, 0)));
+
+    // Execution reports for every aggressive order, only when asked for
+    // (attached after seeding; without a sink the sweep path skips them)
+    FillSink fill_sink;
+    if (fills) book.set_fill_sink(&fill_sink);
     
     double t = 0.0;
     
-    // Simple weight computation (we'll improve this)
-    auto compute_weights = [&book]() {
-        std::vector<double> w(6, 1.0);
-        const TopOfBook tob = book.top();
-        
-        if (!tob.best_bid_price || !tob.best_ask_price) {
-            return w;
-        }
-        
-        const double spread = *tob.best_ask_price - *tob.best_bid_price;
-        const double spread_ticks = spread / book.tick_size();
-        
-        const double wide = 1.0 + 0.8 * spread_ticks;
-        const double tight = 1.0 + 2.5 / (1.0 + spread_ticks);
-        
-        w[0] = wide;   // Bid Add
-        w[1] = wide;   // Ask Add
-        w[4] = tight;  // Market Buy
-        w[5] = tight;  // Market Sell
-        
-        return w;
-    };
-    
     // Simulation loop
     for (int n = 0; n < num_events; ++n) {
-        process.set_weights(compute_weights());
-        Event e = process.next(t);
+        process->set_weights(book_weights(book, *process));
+        Event e = process->next(t);
         t = e.t;
         
-        // Safety: keep book alive
-        TopOfBook tob = book.top();
-        if (!tob.best_bid_price) {
-            book.apply({t, EventType::Add, Side::Bid, price_center - tick_size, 50});
-        }
-        if (!tob.best_ask_price) {
-            book.apply({t, EventType::Add, Side::Ask, price_center + tick_size, 50});
-        }
-        
-        tob = book.top();
-        const double best_bid = *tob.best_bid_price;
-        const double best_ask = *tob.best_ask_price;
+        place_event(book, e, center, place_rng);
         
-        // RNG for placement (seeded for reproducibility per event)
-        std::mt19937 place_rng(static_cast<unsigned>(t * 1000 + n));
-        std::uniform_int_distribution<int> place_dist(0, 99);
-        std::uniform_int_distribution<int> depth_dist(1, 5);
-
-        const double spread_ticks = (best_ask - best_bid) / tick_size;
-
-        // Realistic placement logic
-        if (e.type == EventType::Add) {
-            double improve_prob = (spread_ticks >= 3.0) ? 0.45 : 0.20;
-            double join_prob = 0.50;
-            
-            int roll = place_dist(place_rng);
-            
-            if (e.side == Side::Bid) {
-                // Try to improve the bid
-                if (roll < static_cast<int>(improve_prob * 100) && (best_bid + tick_size < best_ask)) {
-                    e.price = best_bid + tick_size;
-                } 
-                // Join the best bid
-                else if (roll < static_cast<int>((improve_prob + join_prob) * 100)) {
-                    e.price = best_bid;
-                } 
-                // Place behind the best bid
-                else {
-                    int depth = depth_dist(place_rng);
-                    e.price = best_bid - depth * tick_size;
-                }
-            } else {  // Ask side
-                // Try to improve the ask
-                if (roll < static_cast<int>(improve_prob * 100) && (best_ask - tick_size > best_bid)) {
-                    e.price = best_ask - tick_size;
-                } 
-                // Join the best ask
-                else if (roll < static_cast<int>((improve_prob + join_prob) * 100)) {
-                    e.price = best_ask;
-                } 
-                // Place behind the best ask
-                else {
-                    int depth = depth_dist(place_rng);
-                    e.price = best_ask + depth * tick_size;
-                }
-            }
-        } else if (e.type == EventType::Cancel) {
-            e.price = (e.side == Side::Bid) ? best_bid : best_ask;
-        }
-        
-        // Apply event
-        book.apply(e);
+        // Apply event and record the top of book in the same pass
+        if (fills) fill_sink.clear();
+        touch.apply(book, e, times.size());
+        if (fills) executions.record(fill_sink, tick_size);
         
         // Record results
-        const TopOfBook tob_after = book.top();
-        const Metrics m = book.metrics();
+        if (analytics) depth_analytics.record(book.extended_metrics());
+        l2_history.record(times.size(), book);
         
         times.push_back(t);
         event_types.push_back(static_cast<int>(e.type));
         sides.push_back(static_cast<int>(e.side));
         quantities.push_back(e.quantity);
-        prices.push_back(e.price);
-        
-        if (tob_after.best_bid_price) best_bids.push_back(*tob_after.best_bid_price);
-        else best_bids.push_back(std::nan(""));
-        
-        if (tob_after.best_ask_price) best_asks.push_back(*tob_after.best_ask_price);
-        else best_asks.push_back(std::nan(""));
-        
-        if (m.mid) mids.push_back(*m.mid);
-        else mids.push_back(std::nan(""));
-        
-        if (m.spread) spreads.push_back(*m.spread);
-        else spreads.push_back(std::nan(""));
+        prices.push_back(book.to_price(e.price));
     }
     
     // Return as Python dict (will convert to pandas DataFrame in Python)
@@ -168,10 +372,10 @@ py::dict run_simulation(
     results["side"] = sides;
     results["qty"] = quantities;
     results["price"] = prices;
-    results["best_bid"] = best_bids;
-    results["best_ask"] = best_asks;
-    results["mid"] = mids;
-    results["spread"] = spreads;
+    touch.export_to(results, book);
+    if (fills) executions.export_to(results);
+    if (analytics) depth_analytics.export_to(results);
+    l2_history.export_to(results);
     
     return results;
 }
@@ -182,21 +386,28 @@ py::dict run_regime_simulation(
     double price_center,
     double tick_size,
     int qty_min,
-    int qty_max
+    int qty_max,
+    int depth_levels,
+    const std::string& engine,
+    bool fills,
+    bool analytics
 ) {
     // Validate input
     if (regimes.empty()) {
         throw std::runtime_error("At least one regime must be specified");
     }
+
+    std::size_t total_events = 0;
+    for (const auto& regime : regimes) {
+        total_events += static_cast<std::size_t>(std::max(regime["num_events"].cast<int>(), 0));
+    }
     
-    // Create order book
+    // Create order book (prices are integer ticks until output)
     OrderBook book(tick_size);
+    const Tick center = to_ticks(price_center, tick_size);
     
     // Seed initial book depth
-    for (int k = 1; k <= 10; ++k) {
-        book.apply({0.0, EventType::Add, Side::Bid, price_center - k * tick_size, 60});
-        book.apply({0.0, EventType::Add, Side::Ask, price_center + k * tick_size, 60});
-    }
+    seed_book(book, center);
     
     // Storage for results
     std::vector<double> times;
@@ -204,35 +415,18 @@ py::dict run_regime_simulation(
     std::vector<int> sides;
     std::vector<int> quantities;
     std::vector<double> prices;
-    std::vector<double> best_bids;
-    std::vector<double> best_asks;
-    std::vector<double> mids;
-    std::vector<double> spreads;
+    TouchColumns touch(total_events);
+    ExecutionColumns executions;
+    AnalyticsColumns depth_analytics;
+    DepthColumns l2_history(total_events, static_cast<std::size_t>(std::max(depth_levels, 0)));
+
+    // Execution reports for every aggressive order, only when asked for
+    FillSink fill_sink;
+    if (fills) book.set_fill_sink(&fill_sink);
     std::vector<int> regime_ids;  // NEW: track which regime generated each event
     
     double t = 0.0;
     
-    // Weight computation helper
-    auto compute_weights = [&book, tick_size]() {
-        std::vector<double> w(6, 1.0);
-        const TopOfBook tob = book.top();
-        
-        if (!tob.best_bid_price || !tob.best_ask_price) {
-            return w;
-        }
-        
-        const double spread = *tob.best_ask_price - *tob.best_bid_price;
-        const double spread_ticks = spread / tick_size;
-        
-        const double wide = 1.0 + 0.8 * spread_ticks;
-        const double tight = 1.0 + 2.5 / (1.0 + spread_ticks);
-        
-        w[0] = wide;   w[1] = wide;
-        w[4] = tight;  w[5] = tight;
-        
-        return w;
-    };
-    
     // Process each regime
     for (std::size_t regime_idx = 0; regime_idx < regimes.size(); ++regime_idx) {
         const py::dict& regime = regimes[regime_idx];
@@ -245,99 +439,33 @@ py::dict run_regime_simulation(
         unsigned seed = regime["seed"].cast<unsigned>();
         
         // Create Hawkes process for this regime
-        HawkesMultivariateProcess process(mu, alpha, beta, qty_min, qty_max, seed);
+        auto process = make_process(engine, mu, alpha, beta, qty_min, qty_max, seed);
+        PlacementRng place_rng = PlacementRng::stream(seed, 1);
         
         // Run this regime
         for (int n = 0; n < num_events; ++n) {
-            process.set_weights(compute_weights());
-            Event e = process.next(t);
+            process->set_weights(book_weights(book, *process));
+            Event e = process->next(t);
             t = e.t;
             
-            // Safety: keep book alive
-            TopOfBook tob = book.top();
-            if (!tob.best_bid_price) {
-                book.apply({t, EventType::Add, Side::Bid, price_center - tick_size, 50});
-            }
-            if (!tob.best_ask_price) {
-                book.apply({t, EventType::Add, Side::Ask, price_center + tick_size, 50});
-            }
-            
-            tob = book.top();
-            const double best_bid = *tob.best_bid_price;
-            const double best_ask = *tob.best_ask_price;
-            
-            // Simple placement logic
             // Realistic placement logic with price discovery
-            std::mt19937 place_rng(static_cast<unsigned>(t * 1000) + n);
-            std::uniform_int_distribution<int> place_dist(0, 99);
-            std::uniform_int_distribution<int> depth_dist(1, 5);
-
-            const double spread_ticks = (best_ask - best_bid) / tick_size;
-
-            if (e.type == EventType::Add) {
-                double improve_prob = (spread_ticks >= 3.0) ? 0.45 : 0.20;
-                double join_prob = 0.50;
-                
-                int roll = place_dist(place_rng);
-                
-                if (e.side == Side::Bid) {
-                    // Try to improve the bid
-                    if (roll < static_cast<int>(improve_prob * 100) && (best_bid + tick_size < best_ask)) {
-                        e.price = best_bid + tick_size;
-                    } 
-                    // Join the best bid
-                    else if (roll < static_cast<int>((improve_prob + join_prob) * 100)) {
-                        e.price = best_bid;
-                    } 
-                    // Place behind the best bid
-                    else {
-                        int depth = depth_dist(place_rng);
-                        e.price = best_bid - depth * tick_size;
-                    }
-                } else {  // Ask side
-                    // Try to improve the ask
-                    if (roll < static_cast<int>(improve_prob * 100) && (best_ask - tick_size > best_bid)) {
-                        e.price = best_ask - tick_size;
-                    } 
-                    // Join the best ask
-                    else if (roll < static_cast<int>((improve_prob + join_prob) * 100)) {
-                        e.price = best_ask;
-                    } 
-                    // Place behind the best ask
-                    else {
-                        int depth = depth_dist(place_rng);
-                        e.price = best_ask + depth * tick_size;
-                    }
-                }
-            } else if (e.type == EventType::Cancel) {
-                e.price = (e.side == Side::Bid) ? best_bid : best_ask;
-            }
+            place_event(book, e, center, place_rng);
             
-            // Apply event
-            book.apply(e);
+            // Apply event and record the top of book in the same pass
+            if (fills) fill_sink.clear();
+            touch.apply(book, e, times.size());
+            if (fills) executions.record(fill_sink, tick_size);
             
             // Record results
-            const TopOfBook tob_after = book.top();
-            const Metrics m = book.metrics();
+            if (analytics) depth_analytics.record(book.extended_metrics());
+            l2_history.record(times.size(), book);
             
             times.push_back(t);
             event_types.push_back(static_cast<int>(e.type));
             sides.push_back(static_cast<int>(e.side));
             quantities.push_back(e.quantity);
-            prices.push_back(e.price);
+            prices.push_back(book.to_price(e.price));
             regime_ids.push_back(static_cast<int>(regime_idx));  // Track regime
-            
-            if (tob_after.best_bid_price) best_bids.push_back(*tob_after.best_bid_price);
-            else best_bids.push_back(std::nan(""));
-            
-            if (tob_after.best_ask_price) best_asks.push_back(*tob_after.best_ask_price);
-            else best_asks.push_back(std::nan(""));
-            
-            if (m.mid) mids.push_back(*m.mid);
-            else mids.push_back(std::nan(""));
-            
-            if (m.spread) spreads.push_back(*m.spread);
-            else spreads.push_back(std::nan(""));
         }
     }
     
@@ -348,12 +476,340 @@ py::dict run_regime_simulation(
     results["side"] = sides;
     results["qty"] = quantities;
     results["price"] = prices;
+    touch.export_to(results, book);
+    if (fills) executions.export_to(results);
+    if (analytics) depth_analytics.export_to(results);
+    l2_history.export_to(results);
+    results["regime"] = regime_ids;  // NEW field
+    
+    return results;
+}
+
+// Monte Carlo paths sharing one warm-up. The book and the Hawkes state are
+// checkpointed after warmup_events, and every path restarts from that point
+// with its own RNG stream instead of re-simulating the burn-in.
+// Returns (num_paths x num_events) matrices.
+py::dict run_forked_simulation(
+    const std::vector<double>& mu,
+    const std::vector<std::vector<double>>& alpha,
+    const std::vector<std::vector<double>>& beta,
+    int warmup_events,
+    int num_paths,
+    int num_events,
+    double price_center,
+    double tick_size,
+    int qty_min,
+    int qty_max,
+    unsigned seed,
+    const std::string& engine
+) {
+    if (num_paths <= 0 || num_events <= 0) {
+        throw std::runtime_error("num_paths and num_events must be positive");
+    }
+
+    OrderBook book(tick_size);
+    const Tick center = to_ticks(price_center, tick_size);
+    seed_book(book, center);
+
+    auto process = make_process(engine, mu, alpha, beta, qty_min, qty_max, seed);
+
+    // Substreams of the seed: 0 Hawkes and 1 placement for the warm-up, then
+    // two more per path, split off in order with jump()
+    PlacementRng streams = PlacementRng::stream(seed, 1);
+    PlacementRng place_rng = streams;
+
+    // Shared warm-up
+    double t = 0.0;
+    for (int n = 0; n < warmup_events; ++n) {
+        process->set_weights(book_weights(book, *process));
+        Event e = process->next(t);
+        t = e.t;
+
+        place_event(book, e, center, place_rng);
+        book.apply(e);
+    }
+
+    const OrderBook::Checkpoint book_cp = book.checkpoint();
+    const HawkesMultivariateProcess::State process_cp = process->state();
+    const double t0 = t;
+
+    const auto rows = static_cast<std::size_t>(num_paths);
+    const auto cols = static_cast<std::size_t>(num_events);
+    py::array_t<double> times(matrix_shape(rows, cols));
+    py::array_t<int> event_types(matrix_shape(rows, cols));
+    py::array_t<double> best_bids(matrix_shape(rows, cols));
+    py::array_t<double> best_asks(matrix_shape(rows, cols));
+    py::array_t<double> mids(matrix_shape(rows, cols));
+    py::array_t<double> spreads(matrix_shape(rows, cols));
+
+    double* tp = times.mutable_data();
+    int* ep = event_types.mutable_data();
+    double* bp = best_bids.mutable_data();
+    double* ap = best_asks.mutable_data();
+    double* mp = mids.mutable_data();
+    double* sp = spreads.mutable_data();
+
+    // One path's best prices in ticks, converted when the path is done
+    std::vector<Tick> bid_ticks(cols);
+    std::vector<Tick> ask_ticks(cols);
+
+    for (std::size_t path = 0; path < rows; ++path) {
+        // Fork: restore the warmed-up market, then diverge through the RNG
+        book.restore(book_cp);
+        process->restore(process_cp);
+        streams.jump();
+        process->reseed(streams);
+        streams.jump();
+        place_rng = streams;
+        t = t0;
+
+        for (std::size_t n = 0; n < cols; ++n) {
+            process->set_weights(book_weights(book, *process));
+            Event e = process->next(t);
+            t = e.t;
+
+            place_event(book, e, center, place_rng);
+
+            // Mid and spread go straight into the output matrices
+            const std::size_t i = path * cols + n;
+            BookSeries out;
+            out.best_bid = &bid_ticks[n];
+            out.best_ask = &ask_ticks[n];
+            out.mid = mp + i;
+            out.spread = sp + i;
+            book.apply_batch(&e, 1, out);
+
+            tp[i] = t;
+            ep[i] = static_cast<int>(e.type);
+        }
+
+        for (std::size_t n = 0; n < cols; ++n) {
+            const std::size_t i = path * cols + n;
+            bp[i] = bid_ticks[n] ? book.to_price(bid_ticks[n]) : std::nan("");
+            ap[i] = ask_ticks[n] ? book.to_price(ask_ticks[n]) : std::nan("");
+        }
+    }
+
+    py::dict results;
+    results["t"] = times;
+    results["evt"] = event_types;
     results["best_bid"] = best_bids;
     results["best_ask"] = best_asks;
     results["mid"] = mids;
     results["spread"] = spreads;
-    results["regime"] = regime_ids;  // NEW field
-    
+
+    return results;
+}
+
+// Event columns as the simulations return them: evt/side codes, prices in
+// price units
+using DoubleColumn = py::array_t<double, py::array::c_style | py::array::forcecast>;
+using IntColumn = py::array_t<int, py::array::c_style | py::array::forcecast>;
+
+// Decodes an event stream for the replay functions. Checks that the columns
+// have the same length and that every evt/side code names an EventType/Side;
+// non-finite prices (e.g. NaN on Market orders) become tick 0.
+static std::vector<Event> decode_events(
+    const DoubleColumn& t,
+    const IntColumn& evt,
+    const IntColumn& side,
+    const DoubleColumn& price,
+    const IntColumn& qty,
+    double tick_size
+) {
+    const std::size_t n = static_cast<std::size_t>(t.size());
+    if (evt.size() != t.size() || side.size() != t.size() ||
+        price.size() != t.size() || qty.size() != t.size()) {
+        throw std::runtime_error("All event columns must have the same length");
+    }
+
+    const double* tp = t.data();
+    const int* ep = evt.data();
+    const int* sp = side.data();
+    const double* pp = price.data();
+    const int* qp = qty.data();
+
+    std::vector<Event> events(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (ep[i] < static_cast<int>(EventType::Add) || ep[i] > static_cast<int>(EventType::Market)) {
+            throw std::runtime_error("evt[" + std::to_string(i) + "] is not an event type code");
+        }
+        if (sp[i] != static_cast<int>(Side::Bid) && sp[i] != static_cast<int>(Side::Ask)) {
+            throw std::runtime_error("side[" + std::to_string(i) + "] is not a side code");
+        }
+        events[i].t = tp[i];
+        events[i].type = static_cast<EventType>(ep[i]);
+        events[i].side = static_cast<Side>(sp[i]);
+        events[i].price = std::isfinite(pp[i]) ? to_ticks(pp[i], tick_size) : 0;
+        events[i].quantity = qp[i];
+    }
+    return events;
+}
+
+// Replays a pre-generated event stream through a fresh book in one batch pass.
+// Columns follow the simulation output (evt/side codes, prices in price units).
+py::dict replay_events(
+    DoubleColumn t,
+    IntColumn evt,
+    IntColumn side,
+    DoubleColumn price,
+    IntColumn qty,
+    double tick_size
+) {
+    const std::vector<Event> events = decode_events(t, evt, side, price, qty, tick_size);
+    const std::size_t n = events.size();
+
+    std::vector<Tick> bid_ticks(n);
+    std::vector<Tick> ask_ticks(n);
+    py::array_t<int> bid_qty(n);
+    py::array_t<int> ask_qty(n);
+    py::array_t<double> mid(n);
+    py::array_t<double> spread(n);
+    py::array_t<double> imbalance(n);
+    py::array_t<std::uint8_t> accepted(n);
+
+    BookSeries out;
+    out.best_bid = bid_ticks.data();
+    out.best_ask = ask_ticks.data();
+    out.best_bid_qty = bid_qty.mutable_data();
+    out.best_ask_qty = ask_qty.mutable_data();
+    out.mid = mid.mutable_data();
+    out.spread = spread.mutable_data();
+    out.imbalance_top1 = imbalance.mutable_data();
+    out.accepted = accepted.mutable_data();
+
+    OrderBook book(tick_size);
+    book.apply_batch(events.data(), n, out);
+
+    // Prices leave the engine as doubles; empty sides (tick 0) become NaN
+    py::array_t<double> best_bid(n);
+    py::array_t<double> best_ask(n);
+    double* bb = best_bid.mutable_data();
+    double* ba = best_ask.mutable_data();
+    for (std::size_t i = 0; i < n; ++i) {
+        bb[i] = bid_ticks[i] ? book.to_price(bid_ticks[i]) : std::nan("");
+        ba[i] = ask_ticks[i] ? book.to_price(ask_ticks[i]) : std::nan("");
+    }
+
+    py::dict results;
+    results["best_bid"] = best_bid;
+    results["best_bid_qty"] = bid_qty;
+    results["best_ask"] = best_ask;
+    results["best_ask_qty"] = ask_qty;
+    results["mid"] = mid;
+    results["spread"] = spread;
+    results["imbalance_top1"] = imbalance;
+    results["accepted"] = accepted;
+
+    return results;
+}
+
+// Replays an event stream, then answers depth queries on the resulting book
+// through the Fenwick depth index: for each size in `sizes` the VWAP and worst
+// price of an immediate buy/sell (NaN when the side cannot fill it), and for
+// each k in `within_ticks` the resting quantity within k ticks of each touch.
+py::dict book_depth_profile(
+    DoubleColumn t,
+    IntColumn evt,
+    IntColumn side,
+    DoubleColumn price,
+    IntColumn qty,
+    py::array_t<std::int64_t, py::array::c_style | py::array::forcecast> sizes,
+    py::array_t<std::int64_t, py::array::c_style | py::array::forcecast> within_ticks,
+    double tick_size
+) {
+    const std::vector<Event> events = decode_events(t, evt, side, price, qty, tick_size);
+
+    OrderBook book(tick_size);
+    book.enable_depth_index();
+    for (const Event& e : events) book.apply(e);
+
+    const std::size_t m = static_cast<std::size_t>(sizes.size());
+    py::array_t<double> buy_vwap(m);
+    py::array_t<double> buy_worst(m);
+    py::array_t<double> sell_vwap(m);
+    py::array_t<double> sell_worst(m);
+    double* bv = buy_vwap.mutable_data();
+    double* bw = buy_worst.mutable_data();
+    double* sv = sell_vwap.mutable_data();
+    double* sw = sell_worst.mutable_data();
+
+    const std::int64_t* xs = sizes.data();
+    for (std::size_t j = 0; j < m; ++j) {
+        const std::int64_t x = xs[j];
+        const auto buy = book.sweep_cost(Side::Bid, x);
+        const auto sell = book.sweep_cost(Side::Ask, x);
+        const bool buy_ok = x > 0 && buy.filled == x;
+        const bool sell_ok = x > 0 && sell.filled == x;
+
+        bv[j] = buy_ok ? static_cast<double>(buy.notional) / x * tick_size : std::nan("");
+        bw[j] = buy_ok ? book.to_price(buy.last_price) : std::nan("");
+        sv[j] = sell_ok ? static_cast<double>(sell.notional) / x * tick_size : std::nan("");
+        sw[j] = sell_ok ? book.to_price(sell.last_price) : std::nan("");
+    }
+
+    const std::size_t k = static_cast<std::size_t>(within_ticks.size());
+    py::array_t<std::int64_t> bid_within(k);
+    py::array_t<std::int64_t> ask_within(k);
+    std::int64_t* bd = bid_within.mutable_data();
+    std::int64_t* ad = ask_within.mutable_data();
+    const std::int64_t* ks = within_ticks.data();
+    for (std::size_t j = 0; j < k; ++j) {
+        bd[j] = book.depth_within(Side::Bid, ks[j]);
+        ad[j] = book.depth_within(Side::Ask, ks[j]);
+    }
+
+    py::dict results;
+    results["buy_vwap"] = buy_vwap;
+    results["buy_worst_price"] = buy_worst;
+    results["sell_vwap"] = sell_vwap;
+    results["sell_worst_price"] = sell_worst;
+    results["bid_depth_within"] = bid_within;
+    results["ask_depth_within"] = ask_within;
+
+    return results;
+}
+
+// Replays an event stream and returns the market-by-price feed it produces:
+// one row per level change, "level `price` on `side` is now `qty`".
+py::dict level_deltas(
+    DoubleColumn t,
+    IntColumn evt,
+    IntColumn side,
+    DoubleColumn price,
+    IntColumn qty,
+    double tick_size
+) {
+    const std::vector<Event> events = decode_events(t, evt, side, price, qty, tick_size);
+
+    OrderBook book(tick_size);
+    DeltaSink sink(2 * events.size());
+    book.set_delta_sink(&sink);
+    for (const Event& e : events) book.apply(e);
+
+    const auto& deltas = sink.deltas();
+    const std::size_t m = deltas.size();
+    py::array_t<double> out_t(m);
+    py::array_t<int> out_side(m);
+    py::array_t<double> out_price(m);
+    py::array_t<int> out_qty(m);
+    double* ot = out_t.mutable_data();
+    int* os = out_side.mutable_data();
+    double* op = out_price.mutable_data();
+    int* oq = out_qty.mutable_data();
+    for (std::size_t i = 0; i < m; ++i) {
+        ot[i] = deltas[i].t;
+        os[i] = static_cast<int>(deltas[i].side);
+        op[i] = book.to_price(deltas[i].price);
+        oq[i] = deltas[i].qty;
+    }
+
+    py::dict results;
+    results["t"] = out_t;
+    results["side"] = out_side;
+    results["price"] = out_price;
+    results["qty"] = out_qty;
+
     return results;
 }
 
@@ -372,6 +828,10 @@ PYBIND11_MODULE(lob_core, m) {
           py::arg("qty_min") = 5,
           py::arg("qty_max") = 50,
           py::arg("seed") = 42,
+          py::arg("depth_levels") = 0,
+          py::arg("engine") = "thinning",
+          py::arg("fills") = false,
+          py::arg("analytics") = false,
           "Run LOB simulation with Hawkes process");
     
     // NEW: Regime-switching simulation
@@ -381,5 +841,53 @@ PYBIND11_MODULE(lob_core, m) {
           py::arg("tick_size") = 0.1,
           py::arg("qty_min") = 5,
           py::arg("qty_max") = 50,
+          py::arg("depth_levels") = 0,
+          py::arg("engine") = "thinning",
+          py::arg("fills") = false,
+          py::arg("analytics") = false,
           "Run LOB simulation with regime-switching Hawkes process");
+
+    m.def("run_forked_simulation", &run_forked_simulation,
+          py::arg("mu"),
+          py::arg("alpha"),
+          py::arg("beta"),
+          py::arg("warmup_events") = 1000,
+          py::arg("num_paths") = 100,
+          py::arg("num_events") = 1000,
+          py::arg("price_center") = 100.0,
+          py::arg("tick_size") = 0.1,
+          py::arg("qty_min") = 5,
+          py::arg("qty_max") = 50,
+          py::arg("seed") = 42,
+          py::arg("engine") = "thinning",
+          "Run Monte Carlo paths forked from one shared warm-up");
+
+    m.def("replay_events", &replay_events,
+          py::arg("t"),
+          py::arg("evt"),
+          py::arg("side"),
+          py::arg("price"),
+          py::arg("qty"),
+          py::arg("tick_size") = 0.1,
+          "Replay an event stream through an empty book in one batch pass");
+
+    m.def("book_depth_profile", &book_depth_profile,
+          py::arg("t"),
+          py::arg("evt"),
+          py::arg("side"),
+          py::arg("price"),
+          py::arg("qty"),
+          py::arg("sizes"),
+          py::arg("within_ticks"),
+          py::arg("tick_size") = 0.1,
+          "Replay an event stream and query sweep costs and depth on the final book");
+
+    m.def("level_deltas", &level_deltas,
+          py::arg("t"),
+          py::arg("evt"),
+          py::arg("side"),
+          py::arg("price"),
+          py::arg("qty"),
+          py::arg("tick_size") = 0.1,
+          "Replay an event stream and return its market-by-price level updates");
 }
\ No newline at end of file